@@ -0,0 +1,235 @@
+/**************************************************************************/
+/*  async_file_reader.cpp                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "async_file_reader.h"
+
+#include "core/io/file_access_pack.h"
+
+AsyncFileReader *AsyncFileReader::singleton = nullptr;
+
+void AsyncFileReader::_start_threads() {
+	threads = memnew_arr(Thread, THREAD_COUNT);
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		threads[i].start(&AsyncFileReader::_thread_function, this);
+	}
+	threads_started = true;
+}
+
+void AsyncFileReader::_process_batch(const LocalVector<Request *> &p_batch, Ref<FileAccess> &r_file, String &r_file_path) {
+	const String &path = p_batch[0]->source_path;
+	if (r_file.is_null() || r_file_path != path) {
+		r_file = FileAccess::open(path, FileAccess::READ);
+		r_file_path = path;
+	}
+
+	if (r_file.is_null()) {
+		return; // Results stay at -1.
+	}
+
+	LocalVector<uint8_t> buffer;
+	uint32_t i = 0;
+	while (i < p_batch.size()) {
+		// Gather the following requests that are close enough to be read at once.
+		uint64_t run_begin = p_batch[i]->source_offset;
+		uint64_t run_end = run_begin + p_batch[i]->length;
+		uint32_t run_count = 1;
+		while (i + run_count < p_batch.size()) {
+			const Request *next = p_batch[i + run_count];
+			uint64_t next_end = MAX(run_end, next->source_offset + next->length);
+			if (next->source_offset > run_end + MAX_COALESCE_GAP || next_end - run_begin > MAX_COALESCED_LENGTH) {
+				break;
+			}
+			run_end = next_end;
+			run_count++;
+		}
+
+		r_file->seek(run_begin);
+		if (run_count == 1) {
+			Request *request = p_batch[i];
+			request->result = request->length ? (int64_t)r_file->get_buffer(request->dst, request->length) : 0;
+		} else {
+			buffer.resize(run_end - run_begin);
+			uint64_t read = r_file->get_buffer(buffer.ptr(), buffer.size());
+			for (uint32_t j = i; j < i + run_count; j++) {
+				Request *request = p_batch[j];
+				uint64_t from = request->source_offset - run_begin;
+				uint64_t available = read > from ? read - from : 0;
+				request->result = MIN(request->length, available);
+				if (request->result > 0) {
+					memcpy(request->dst, buffer.ptr() + from, request->result);
+				}
+			}
+		}
+
+		i += run_count;
+	}
+}
+
+void AsyncFileReader::_thread_function(void *p_user) {
+	AsyncFileReader *reader = (AsyncFileReader *)p_user;
+
+	// Kept open as long as requests keep coming for the same file.
+	Ref<FileAccess> file;
+	String file_path;
+
+	LocalVector<Request *> batch;
+	while (true) {
+		reader->semaphore.wait();
+
+		batch.clear();
+		{
+			MutexLock lock(reader->mutex);
+			if (reader->exit_threads) {
+				break;
+			}
+
+			// Take every pending request on the same file, in offset order.
+			if (!reader->pending.is_empty()) {
+				reader->pending.sort_custom<RequestSort>();
+				const String &path = reader->pending[0]->source_path;
+				uint32_t count = 1;
+				while (count < reader->pending.size() && reader->pending[count]->source_path == path) {
+					count++;
+				}
+				batch.resize(count);
+				for (uint32_t i = 0; i < count; i++) {
+					batch[i] = reader->pending[i];
+				}
+				for (uint32_t i = count; i < reader->pending.size(); i++) {
+					reader->pending[i - count] = reader->pending[i];
+				}
+				reader->pending.resize(reader->pending.size() - count);
+			}
+		}
+
+		if (batch.is_empty()) {
+			continue; // Its requests were taken by another thread's batch.
+		}
+
+		reader->_process_batch(batch, file, file_path);
+
+		bool idle = false;
+		{
+			MutexLock lock(reader->mutex);
+			for (Request *request : batch) {
+				request->completed = true;
+			}
+			reader->completed_cond.notify_all();
+			idle = reader->pending.is_empty();
+		}
+
+		if (idle) {
+			file.unref();
+		}
+	}
+}
+
+AsyncFileReader::RequestID AsyncFileReader::read(const String &p_path, uint64_t p_offset, uint8_t *p_dst, uint64_t p_length) {
+	ERR_FAIL_COND_V(!p_dst && p_length > 0, INVALID_REQUEST_ID);
+
+	Request request;
+	request.source_path = p_path;
+	request.source_offset = p_offset;
+	request.length = p_length;
+	request.dst = p_dst;
+
+	// Read packed files straight from the pack, clamped to their size.
+	PackedData *packed_data = PackedData::get_singleton();
+	String pack_path;
+	uint64_t file_offset = 0;
+	uint64_t file_size = 0;
+	if (packed_data && !packed_data->is_disabled() && packed_data->get_path_location(p_path, pack_path, file_offset, file_size)) {
+		request.source_path = pack_path;
+		request.source_offset = file_offset + MIN(p_offset, file_size);
+		request.length = p_offset < file_size ? MIN(p_length, file_size - p_offset) : 0;
+	}
+
+	RequestID id;
+	{
+		MutexLock lock(mutex);
+		id = ++last_id;
+		Request *stored = &requests.insert(id, request)->value;
+#ifdef THREADS_ENABLED
+		pending.push_back(stored);
+		if (!threads_started) {
+			_start_threads();
+		}
+		semaphore.post();
+#else
+		LocalVector<Request *> batch;
+		batch.push_back(stored);
+		Ref<FileAccess> file;
+		String file_path;
+		_process_batch(batch, file, file_path);
+		stored->completed = true;
+#endif
+	}
+	return id;
+}
+
+bool AsyncFileReader::is_completed(RequestID p_request) const {
+	MutexLock lock(mutex);
+	const Request *request = requests.getptr(p_request);
+	ERR_FAIL_NULL_V_MSG(request, false, "Invalid async file read request ID.");
+	return request->completed;
+}
+
+int64_t AsyncFileReader::wait(RequestID p_request) {
+	MutexLock lock(mutex);
+	Request *request = requests.getptr(p_request);
+	ERR_FAIL_NULL_V_MSG(request, -1, "Invalid async file read request ID.");
+
+	while (!request->completed) {
+		completed_cond.wait(lock);
+	}
+
+	int64_t result = request->result;
+	requests.erase(p_request);
+	return result;
+}
+
+AsyncFileReader::AsyncFileReader() {
+	singleton = this;
+}
+
+AsyncFileReader::~AsyncFileReader() {
+	if (threads_started) {
+		{
+			MutexLock lock(mutex);
+			exit_threads = true;
+		}
+		semaphore.post(THREAD_COUNT);
+		for (int i = 0; i < THREAD_COUNT; i++) {
+			threads[i].wait_to_finish();
+		}
+		memdelete_arr(threads);
+	}
+	singleton = nullptr;
+}
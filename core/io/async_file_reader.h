@@ -0,0 +1,110 @@
+/**************************************************************************/
+/*  async_file_reader.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef ASYNC_FILE_READER_H
+#define ASYNC_FILE_READER_H
+
+#include "core/io/file_access.h"
+#include "core/os/condition_variable.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/string/ustring.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// Reads byte ranges of files on dedicated I/O threads, so streaming code never
+// blocks on disk. Requests are queued with read(), then polled with
+// is_completed() and collected with wait(), which every request needs.
+// Pending requests on the same file are sorted and adjacent ranges coalesced
+// into a single read. Files inside a PCK are read straight from the pack, so
+// neighboring packed files coalesce too.
+class AsyncFileReader {
+public:
+	enum {
+		INVALID_REQUEST_ID = -1
+	};
+
+	typedef int64_t RequestID;
+
+private:
+	enum {
+		THREAD_COUNT = 2,
+		MAX_COALESCE_GAP = 4096, // Bytes read and thrown away to join two ranges.
+		MAX_COALESCED_LENGTH = 1 << 20,
+	};
+
+	struct Request {
+		String source_path; // File actually read: the pack, for packed files.
+		uint64_t source_offset = 0;
+		uint64_t length = 0;
+		uint8_t *dst = nullptr;
+		int64_t result = -1;
+		bool completed = false;
+	};
+
+	static AsyncFileReader *singleton;
+
+	BinaryMutex mutex;
+	Semaphore semaphore;
+	ConditionVariable completed_cond;
+	HashMap<RequestID, Request> requests;
+	LocalVector<Request *> pending;
+	RequestID last_id = 0;
+	bool exit_threads = false;
+
+	Thread *threads = nullptr;
+	bool threads_started = false;
+
+	struct RequestSort {
+		_FORCE_INLINE_ bool operator()(const Request *p_a, const Request *p_b) const {
+			if (p_a->source_path != p_b->source_path) {
+				return p_a->source_path < p_b->source_path;
+			}
+			return p_a->source_offset < p_b->source_offset;
+		}
+	};
+
+	void _start_threads();
+	void _process_batch(const LocalVector<Request *> &p_batch, Ref<FileAccess> &r_file, String &r_file_path);
+	static void _thread_function(void *p_user);
+
+public:
+	static AsyncFileReader *get_singleton() { return singleton; }
+
+	RequestID read(const String &p_path, uint64_t p_offset, uint8_t *p_dst, uint64_t p_length);
+	bool is_completed(RequestID p_request) const;
+	int64_t wait(RequestID p_request); // Returns the bytes read, or -1 if the file couldn't be opened.
+
+	AsyncFileReader();
+	~AsyncFileReader();
+};
+
+#endif // ASYNC_FILE_READER_H
@@ -32,6 +32,9 @@
 
 #include "core/config/project_settings.h"
 #include "core/io/zip_io.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 
 #include "thirdparty/misc/fastlz.h"
 
@@ -42,6 +45,62 @@
 #include <brotli/decode.h>
 #endif
 
+// Zstandard contexts are costly to create, so each thread keeps its own around and resets it between uses.
+// Worker threads live as long as the process, so contexts that grew large (e.g. for long distance
+// matching windows) are freed right after use rather than kept.
+static const size_t ZSTD_MAX_KEPT_CONTEXT_SIZE = 8 * 1024 * 1024;
+
+struct ZSTDThreadContexts {
+	ZSTD_CCtx *cctx = nullptr;
+	ZSTD_DCtx *dctx = nullptr;
+
+	ZSTD_CCtx *get_cctx() {
+		if (cctx) {
+			ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
+		} else {
+			cctx = ZSTD_createCCtx();
+		}
+		return cctx;
+	}
+
+	ZSTD_DCtx *get_dctx() {
+		if (dctx) {
+			ZSTD_DCtx_reset(dctx, ZSTD_reset_session_and_parameters);
+		} else {
+			dctx = ZSTD_createDCtx();
+		}
+		return dctx;
+	}
+
+	void release_cctx() {
+		if (cctx && ZSTD_sizeof_CCtx(cctx) > ZSTD_MAX_KEPT_CONTEXT_SIZE) {
+			ZSTD_freeCCtx(cctx);
+			cctx = nullptr;
+		}
+	}
+
+	void release_dctx() {
+		if (dctx && ZSTD_sizeof_DCtx(dctx) > ZSTD_MAX_KEPT_CONTEXT_SIZE) {
+			ZSTD_freeDCtx(dctx);
+			dctx = nullptr;
+		}
+	}
+
+	~ZSTDThreadContexts() {
+		if (cctx) {
+			ZSTD_freeCCtx(cctx);
+		}
+		if (dctx) {
+			ZSTD_freeDCtx(dctx);
+		}
+	}
+};
+
+static thread_local ZSTDThreadContexts zstd_thread_contexts;
+
+// Below this size, splitting work across threads costs more than it saves.
+static const uint64_t BLOCKS_PARALLEL_MIN_SIZE = 256 * 1024;
+
 int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode) {
 	switch (p_mode) {
 		case MODE_BROTLI: {
@@ -84,7 +143,7 @@ int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size,
 
 		} break;
 		case MODE_ZSTD: {
-			ZSTD_CCtx *cctx = ZSTD_createCCtx();
+			ZSTD_CCtx *cctx = zstd_thread_contexts.get_cctx();
 			ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, zstd_level);
 			if (zstd_long_distance_matching) {
 				ZSTD_CCtx_setParameter(cctx, ZSTD_c_enableLongDistanceMatching, 1);
@@ -92,7 +151,7 @@ int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size,
 			}
 			int max_dst_size = get_max_compressed_buffer_size(p_src_size, MODE_ZSTD);
 			int ret = ZSTD_compressCCtx(cctx, p_dst, max_dst_size, p_src, p_src_size, zstd_level);
-			ZSTD_freeCCtx(cctx);
+			zstd_thread_contexts.release_cctx();
 			return ret;
 		} break;
 	}
@@ -187,12 +246,12 @@ int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p
 			return total;
 		} break;
 		case MODE_ZSTD: {
-			ZSTD_DCtx *dctx = ZSTD_createDCtx();
+			ZSTD_DCtx *dctx = zstd_thread_contexts.get_dctx();
 			if (zstd_long_distance_matching) {
 				ZSTD_DCtx_setParameter(dctx, ZSTD_d_windowLogMax, zstd_window_log_size);
 			}
 			int ret = ZSTD_decompressDCtx(dctx, p_dst, p_dst_max_size, p_src, p_src_size);
-			ZSTD_freeDCtx(dctx);
+			zstd_thread_contexts.release_dctx();
 			return ret;
 		} break;
 	}
@@ -349,6 +408,122 @@ int Compression::decompress_dynamic(Vector<uint8_t> *p_dst_vect, int p_max_dst_s
 	}
 }
 
+struct CompressionBlocks {
+	Compression::Mode mode = Compression::MODE_ZSTD;
+	uint32_t block_size = 0;
+	uint32_t block_count = 0;
+
+	const uint8_t *src = nullptr;
+	uint64_t src_size = 0;
+	const uint64_t *src_offsets = nullptr; // Only when decompressing.
+
+	uint8_t *dst = nullptr;
+	uint64_t dst_size = 0;
+	uint64_t dst_stride = 0; // Only when compressing, each block gets a slot large enough for any output.
+	int *compressed_sizes = nullptr;
+
+	SafeFlag failed;
+
+	static void compress_block(void *p_userdata, uint32_t p_index) {
+		CompressionBlocks *blocks = (CompressionBlocks *)p_userdata;
+		const uint64_t from = (uint64_t)p_index * blocks->block_size;
+		const int size = MIN((uint64_t)blocks->block_size, blocks->src_size - from);
+		blocks->compressed_sizes[p_index] = Compression::compress(blocks->dst + p_index * blocks->dst_stride, blocks->src + from, size, blocks->mode);
+		if (blocks->compressed_sizes[p_index] < 0) {
+			blocks->failed.set();
+		}
+	}
+
+	static void decompress_block(void *p_userdata, uint32_t p_index) {
+		CompressionBlocks *blocks = (CompressionBlocks *)p_userdata;
+		const uint64_t to = (uint64_t)p_index * blocks->block_size;
+		const int size = MIN((uint64_t)blocks->block_size, blocks->dst_size - to);
+		const uint64_t src_size = blocks->src_offsets[p_index + 1] - blocks->src_offsets[p_index];
+		if (Compression::decompress(blocks->dst + to, size, blocks->src + blocks->src_offsets[p_index], src_size, blocks->mode) != size) {
+			blocks->failed.set();
+		}
+	}
+
+	void run(void (*p_func)(void *, uint32_t), uint64_t p_size) {
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		if (pool && block_count > 1 && p_size >= BLOCKS_PARALLEL_MIN_SIZE) {
+			WorkerThreadPool::GroupID group_task = pool->add_native_group_task(p_func, this, block_count, -1, true, SNAME("CompressionBlocks"));
+			pool->wait_for_group_task_completion(group_task);
+		} else {
+			for (uint32_t i = 0; i < block_count; i++) {
+				p_func(this, i);
+			}
+		}
+	}
+};
+
+Error Compression::compress_blocks(Vector<uint8_t> &r_dst, Vector<uint32_t> &r_block_sizes, const uint8_t *p_src, uint64_t p_src_size, uint32_t p_block_size, Mode p_mode) {
+	ERR_FAIL_COND_V(p_block_size == 0 || p_block_size > INT32_MAX, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(!p_src && p_src_size > 0, ERR_INVALID_PARAMETER);
+
+	const int max_block_size = get_max_compressed_buffer_size(p_block_size, p_mode);
+	ERR_FAIL_COND_V(max_block_size < 0, ERR_UNAVAILABLE);
+
+	CompressionBlocks blocks;
+	blocks.mode = p_mode;
+	blocks.block_size = p_block_size;
+	blocks.block_count = (p_src_size + p_block_size - 1) / p_block_size;
+	blocks.src = p_src;
+	blocks.src_size = p_src_size;
+	blocks.dst_stride = max_block_size;
+
+	LocalVector<int> compressed_sizes;
+	compressed_sizes.resize(blocks.block_count);
+	blocks.compressed_sizes = compressed_sizes.ptr();
+
+	ERR_FAIL_COND_V(r_dst.resize(blocks.block_count * blocks.dst_stride) != OK, ERR_OUT_OF_MEMORY);
+	blocks.dst = r_dst.ptrw();
+
+	blocks.run(&CompressionBlocks::compress_block, p_src_size);
+	if (blocks.failed.is_set()) {
+		r_dst.clear();
+		r_block_sizes.clear();
+		return FAILED;
+	}
+
+	// Pack the blocks together, each one moves down to where the previous one ended.
+	r_block_sizes.resize(blocks.block_count);
+	uint64_t dst_size = 0;
+	for (uint32_t i = 0; i < blocks.block_count; i++) {
+		memmove(blocks.dst + dst_size, blocks.dst + i * blocks.dst_stride, compressed_sizes[i]);
+		r_block_sizes.write[i] = compressed_sizes[i];
+		dst_size += compressed_sizes[i];
+	}
+	r_dst.resize(dst_size);
+
+	return OK;
+}
+
+Error Compression::decompress_blocks(uint8_t *p_dst, uint64_t p_dst_size, const uint8_t *p_src, const uint32_t *p_block_sizes, uint32_t p_block_count, uint32_t p_block_size, Mode p_mode) {
+	ERR_FAIL_COND_V(p_block_size == 0 || p_block_size > INT32_MAX, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_block_count != (p_dst_size + p_block_size - 1) / p_block_size, ERR_INVALID_PARAMETER);
+
+	LocalVector<uint64_t> src_offsets;
+	src_offsets.resize(p_block_count + 1);
+	src_offsets[0] = 0;
+	for (uint32_t i = 0; i < p_block_count; i++) {
+		src_offsets[i + 1] = src_offsets[i] + p_block_sizes[i];
+	}
+
+	CompressionBlocks blocks;
+	blocks.mode = p_mode;
+	blocks.block_size = p_block_size;
+	blocks.block_count = p_block_count;
+	blocks.src = p_src;
+	blocks.src_size = src_offsets[p_block_count];
+	blocks.src_offsets = src_offsets.ptr();
+	blocks.dst = p_dst;
+	blocks.dst_size = p_dst_size;
+
+	blocks.run(&CompressionBlocks::decompress_block, p_dst_size);
+	return blocks.failed.is_set() ? ERR_FILE_CORRUPT : OK;
+}
+
 int Compression::zlib_level = Z_DEFAULT_COMPRESSION;
 int Compression::gzip_level = Z_DEFAULT_COMPRESSION;
 int Compression::zstd_level = 3;
@@ -31,6 +31,7 @@
 #ifndef COMPRESSION_H
 #define COMPRESSION_H
 
+#include "core/error/error_list.h"
 #include "core/templates/vector.h"
 #include "core/typedefs.h"
 
@@ -55,6 +56,11 @@ public:
 	static int get_max_compressed_buffer_size(int p_src_size, Mode p_mode = MODE_ZSTD);
 	static int decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD);
 	static int decompress_dynamic(Vector<uint8_t> *p_dst_vect, int p_max_dst_size, const uint8_t *p_src, int p_src_size, Mode p_mode);
+
+	// Data split in independent blocks of p_block_size bytes (the last one can be shorter),
+	// processed in parallel on the WorkerThreadPool when there is enough of it.
+	static Error compress_blocks(Vector<uint8_t> &r_dst, Vector<uint32_t> &r_block_sizes, const uint8_t *p_src, uint64_t p_src_size, uint32_t p_block_size, Mode p_mode = MODE_ZSTD);
+	static Error decompress_blocks(uint8_t *p_dst, uint64_t p_dst_size, const uint8_t *p_src, const uint32_t *p_block_sizes, uint32_t p_block_count, uint32_t p_block_size, Mode p_mode = MODE_ZSTD);
 };
 
 #endif // COMPRESSION_H
@@ -729,19 +729,13 @@ void FileAccess::store_buffer(const Vector<uint8_t> &p_buffer) {
 }
 
 void FileAccess::store_var(const Variant &p_var, bool p_full_objects) {
-	int len;
-	Error err = encode_variant(p_var, nullptr, len, p_full_objects);
-	ERR_FAIL_COND_MSG(err != OK, "Error when trying to encode Variant.");
-
+	int len = 0;
 	Vector<uint8_t> buff;
-	buff.resize(len);
-
-	uint8_t *w = buff.ptrw();
-	err = encode_variant(p_var, &w[0], len, p_full_objects);
+	Error err = encode_variant(p_var, buff, len, p_full_objects);
 	ERR_FAIL_COND_MSG(err != OK, "Error when trying to encode Variant.");
 
 	store_32(len);
-	store_buffer(buff);
+	store_buffer(buff.ptr(), len);
 }
 
 Vector<uint8_t> FileAccess::get_file_as_bytes(const String &p_path, Error *r_error) {
@@ -150,6 +150,8 @@ public:
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const; ///< get an array of bytes
 	Vector<uint8_t> get_buffer(int64_t p_length) const;
+	virtual bool map_data() { return false; } ///< map the whole file read-only if the backend supports it; the file must not be modified on disk while mapped, reading a truncated mapping crashes
+	virtual const uint8_t *get_mapped_data() const { return nullptr; } ///< read-only view of the whole file (get_length() bytes) once mapped, valid while the file is open
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
@@ -144,14 +144,18 @@ void FileAccessCompressed::_close() {
 			f->store_32(0); //compressed sizes, will update later
 		}
 
-		Vector<int> block_sizes;
-		for (uint32_t i = 0; i < bc; i++) {
-			uint32_t bl = i == (bc - 1) ? write_max % block_size : block_size;
-			uint8_t *bp = &write_ptr[i * block_size];
-
+		// Blocks are compressed in parallel. When the data ends on a block boundary,
+		// the format still expects a last, empty block.
+		Vector<uint8_t> cblocks;
+		Vector<uint32_t> block_sizes;
+		Error err = Compression::compress_blocks(cblocks, block_sizes, write_ptr, write_max, block_size, cmode);
+		ERR_FAIL_COND_MSG(err != OK, "Can't compress file '" + f->get_path() + "'.");
+		f->store_buffer(cblocks.ptr(), cblocks.size());
+
+		if ((uint32_t)block_sizes.size() < bc) {
 			Vector<uint8_t> cblock;
-			cblock.resize(Compression::get_max_compressed_buffer_size(bl, cmode));
-			int s = Compression::compress(cblock.ptrw(), bp, bl, cmode);
+			cblock.resize(Compression::get_max_compressed_buffer_size(0, cmode));
+			int s = Compression::compress(cblock.ptrw(), write_ptr, 0, cmode);
 
 			f->store_buffer(cblock.ptr(), s);
 			block_sizes.push_back(s);
@@ -292,6 +296,18 @@ uint8_t FileAccessCompressed::get_8() const {
 	return ret;
 }
 
+bool FileAccessCompressed::_read_block(uint32_t p_block) const {
+	f->seek(read_blocks[p_block].offset);
+	f->get_buffer(comp_buffer.ptrw(), read_blocks[p_block].csize);
+	int ret = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[p_block].csize, cmode);
+	ERR_FAIL_COND_V_MSG(ret == -1, false, "Compressed file is corrupt.");
+
+	read_block = p_block;
+	read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+	read_pos = 0;
+	return true;
+}
+
 uint64_t FileAccessCompressed::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	ERR_FAIL_COND_V(!p_dst && p_length > 0, -1);
 	ERR_FAIL_COND_V_MSG(f.is_null(), -1, "File must be opened before use.");
@@ -302,32 +318,53 @@ uint64_t FileAccessCompressed::get_buffer(uint8_t *p_dst, uint64_t p_length) con
 		return 0;
 	}
 
-	for (uint64_t i = 0; i < p_length; i++) {
-		p_dst[i] = read_ptr[read_pos];
-		read_pos++;
-		if (read_pos >= read_block_size) {
-			read_block++;
+	uint64_t done = 0;
+	while (done < p_length) {
+		const uint64_t to_copy = MIN(p_length - done, (uint64_t)(read_block_size - read_pos));
+		memcpy(p_dst + done, read_ptr + read_pos, to_copy);
+		read_pos += to_copy;
+		done += to_copy;
+		if (read_pos < read_block_size) {
+			break;
+		}
 
-			if (read_block < read_block_count) {
-				//read another block of compressed data
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				int ret = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				ERR_FAIL_COND_V_MSG(ret == -1, -1, "Compressed file is corrupt.");
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
-				read_pos = 0;
-
-			} else {
-				read_block--;
-				at_end = true;
-				if (i + 1 < p_length) {
-					read_eof = true;
-				}
-				return i + 1;
+		uint32_t next_block = read_block + 1;
+		if (next_block >= read_block_count) {
+			at_end = true;
+			if (done < p_length) {
+				read_eof = true;
 			}
+			return done;
 		}
+
+		// Whole blocks the read goes through are decompressed in parallel, straight into p_dst.
+		// The last block is left out, as it's the only one that can be shorter.
+		const uint32_t whole_blocks = MIN((p_length - done) / block_size, (uint64_t)(read_block_count - 1 - next_block));
+		if (whole_blocks > 1) {
+			const uint64_t from = read_blocks[next_block].offset;
+			const uint64_t to = read_blocks[next_block + whole_blocks - 1].offset + read_blocks[next_block + whole_blocks - 1].csize;
+
+			LocalVector<uint32_t> csizes;
+			csizes.resize(whole_blocks);
+			for (uint32_t i = 0; i < whole_blocks; i++) {
+				csizes[i] = read_blocks[next_block + i].csize;
+			}
+
+			Vector<uint8_t> cblocks;
+			cblocks.resize(to - from);
+			f->seek(from);
+			f->get_buffer(cblocks.ptrw(), cblocks.size());
+
+			Error err = Compression::decompress_blocks(p_dst + done, (uint64_t)whole_blocks * block_size, cblocks.ptr(), csizes.ptr(), whole_blocks, block_size, cmode);
+			ERR_FAIL_COND_V_MSG(err != OK, -1, "Compressed file is corrupt.");
+			done += (uint64_t)whole_blocks * block_size;
+			next_block += whole_blocks;
+		}
+
+		ERR_FAIL_COND_V(!_read_block(next_block), -1);
 	}
 
-	return p_length;
+	return done;
 }
 
 Error FileAccessCompressed::get_error() const {
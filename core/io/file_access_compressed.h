@@ -64,6 +64,7 @@ class FileAccessCompressed : public FileAccess {
 	Ref<FileAccess> f;
 
 	void _close();
+	bool _read_block(uint32_t p_block) const;
 
 public:
 	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, uint32_t p_block_size = 4096);
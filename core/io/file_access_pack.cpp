@@ -31,6 +31,7 @@
 #include "file_access_pack.h"
 
 #include "core/io/file_access_encrypted.h"
+#include "core/io/marshalls.h"
 #include "core/object/script_language.h"
 #include "core/os/os.h"
 #include "core/version.h"
@@ -47,7 +48,7 @@ Error PackedData::add_pack(const String &p_path, bool p_replace_files, uint64_t
 	return ERR_FILE_UNRECOGNIZED;
 }
 
-void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted) {
+void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted, bool p_compressed) {
 	String simplified_path = p_path.simplify_path();
 	PathMD5 pmd5(simplified_path.md5_buffer());
 
@@ -55,6 +56,7 @@ void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64
 
 	PackedFile pf;
 	pf.encrypted = p_encrypted;
+	pf.compressed = p_compressed;
 	pf.pack = p_pkg_path;
 	pf.offset = p_ofs;
 	pf.size = p_size;
@@ -105,6 +107,7 @@ void PackedData::add_pack_source(PackSource *p_source) {
 PackedData *PackedData::singleton = nullptr;
 
 PackedData::PackedData() {
+	previous_singleton = singleton;
 	singleton = this;
 	root = memnew(PackedDir);
 
@@ -118,11 +121,52 @@ void PackedData::_free_packed_dirs(PackedDir *p_dir) {
 	memdelete(p_dir);
 }
 
+const uint8_t *PackedData::_get_mapped_file(const PackedFile &p_file, uint64_t *r_available) {
+	if (p_file.encrypted) {
+		return nullptr;
+	}
+
+	MutexLock lock(mapped_packs_mutex);
+
+	HashMap<String, MappedPack>::Iterator E = mapped_packs.find(p_file.pack);
+	if (!E) {
+		// Failures are remembered too, so unmappable packs are only tried once.
+		MappedPack mp;
+		mp.file = FileAccess::open(p_file.pack, FileAccess::READ);
+		if (mp.file.is_valid()) {
+			// Packs are not expected to change while the game runs. Rewriting one on disk
+			// while it is mapped makes reads from it crash instead of failing.
+			mp.data = mp.file->map_data() ? mp.file->get_mapped_data() : nullptr;
+			mp.length = mp.data ? mp.file->get_length() : 0;
+			if (!mp.data) {
+				mp.file.unref();
+			}
+		}
+		E = mapped_packs.insert(p_file.pack, mp);
+	}
+
+	const MappedPack &mp = E->value;
+	// The stored size of compressed files is only known from their block table.
+	const uint64_t stored_size = p_file.compressed ? 0 : p_file.size;
+	if (!mp.data || p_file.offset + stored_size > mp.length) {
+		return nullptr;
+	}
+	if (r_available) {
+		*r_available = mp.length - p_file.offset;
+	}
+	return mp.data + p_file.offset;
+}
+
 PackedData::~PackedData() {
+	mapped_packs.clear();
 	for (int i = 0; i < sources.size(); i++) {
 		memdelete(sources[i]);
 	}
 	_free_packed_dirs(root);
+
+	if (singleton == this) {
+		singleton = previous_singleton;
+	}
 }
 
 //////////////////////////////////////////////////////////////////
@@ -203,7 +247,7 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 	uint32_t ver_minor = f->get_32();
 	f->get_32(); // patch number, not used for validation.
 
-	ERR_FAIL_COND_V_MSG(version != PACK_FORMAT_VERSION, false, "Pack version unsupported: " + itos(version) + ".");
+	ERR_FAIL_COND_V_MSG(version < PACK_FORMAT_VERSION_MIN || version > PACK_FORMAT_VERSION, false, "Pack version unsupported: " + itos(version) + ".");
 	ERR_FAIL_COND_V_MSG(ver_major > VERSION_MAJOR || (ver_major == VERSION_MAJOR && ver_minor > VERSION_MINOR), false, "Pack created with a newer version of the engine: " + itos(ver_major) + "." + itos(ver_minor) + ".");
 
 	uint32_t pack_flags = f->get_32();
@@ -255,7 +299,7 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		f->get_buffer(md5, 16);
 		uint32_t flags = f->get_32();
 
-		PackedData::get_singleton()->add_path(p_path, path, ofs + p_offset, size, md5, this, p_replace_files, (flags & PACK_FILE_ENCRYPTED));
+		PackedData::get_singleton()->add_path(p_path, path, ofs + p_offset, size, md5, this, p_replace_files, (flags & PACK_FILE_ENCRYPTED), (flags & PACK_FILE_COMPRESSED));
 	}
 
 	return true;
@@ -273,7 +317,9 @@ Error FileAccessPack::open_internal(const String &p_path, int p_mode_flags) {
 }
 
 bool FileAccessPack::is_open() const {
-	if (f.is_valid()) {
+	if (mapped || mapped_blocks) {
+		return true;
+	} else if (f.is_valid()) {
 		return f->is_open();
 	} else {
 		return false;
@@ -281,7 +327,7 @@ bool FileAccessPack::is_open() const {
 }
 
 void FileAccessPack::seek(uint64_t p_position) {
-	ERR_FAIL_COND_MSG(f.is_null(), "File must be opened before use.");
+	ERR_FAIL_COND_MSG(!_has_source(), "File must be opened before use.");
 
 	if (p_position > pf.size) {
 		eof = true;
@@ -289,7 +335,9 @@ void FileAccessPack::seek(uint64_t p_position) {
 		eof = false;
 	}
 
-	f->seek(off + p_position);
+	if (!mapped && !compressed) {
+		f->seek(off + p_position);
+	}
 	pos = p_position;
 }
 
@@ -310,18 +358,30 @@ bool FileAccessPack::eof_reached() const {
 }
 
 uint8_t FileAccessPack::get_8() const {
-	ERR_FAIL_COND_V_MSG(f.is_null(), 0, "File must be opened before use.");
+	ERR_FAIL_COND_V_MSG(!_has_source(), 0, "File must be opened before use.");
 	if (pos >= pf.size) {
 		eof = true;
 		return 0;
 	}
 
+	if (mapped) {
+		return mapped[pos++];
+	}
+
+	if (compressed) {
+		if (!_load_block(pos / block_size)) {
+			eof = true;
+			return 0;
+		}
+		return block_cache[pos++ % block_size];
+	}
+
 	pos++;
 	return f->get_8();
 }
 
 uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
-	ERR_FAIL_COND_V_MSG(f.is_null(), -1, "File must be opened before use.");
+	ERR_FAIL_COND_V_MSG(!_has_source(), -1, "File must be opened before use.");
 	ERR_FAIL_COND_V(!p_dst && p_length > 0, -1);
 
 	if (eof) {
@@ -334,21 +394,47 @@ uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 		to_read = (int64_t)pf.size - (int64_t)pos;
 	}
 
+	const uint64_t from = pos;
 	pos += to_read;
 
 	if (to_read <= 0) {
 		return 0;
 	}
-	f->get_buffer(p_dst, to_read);
+
+	if (mapped) {
+		memcpy(p_dst, mapped + from, to_read);
+	} else if (compressed) {
+		uint64_t done = 0;
+		while (done < (uint64_t)to_read) {
+			const uint64_t at = from + done;
+			if (!_load_block(at / block_size)) {
+				eof = true;
+				pos = at;
+				return done;
+			}
+			const uint64_t in_block = at % block_size;
+			const uint64_t n = MIN((uint64_t)to_read - done, block_cache.size() - in_block);
+			memcpy(p_dst + done, block_cache.ptr() + in_block, n);
+			done += n;
+		}
+	} else {
+		f->get_buffer(p_dst, to_read);
+	}
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_mapped_data() const {
+	return mapped;
+}
+
 void FileAccessPack::set_big_endian(bool p_big_endian) {
-	ERR_FAIL_COND_MSG(f.is_null(), "File must be opened before use.");
+	ERR_FAIL_COND_MSG(!_has_source(), "File must be opened before use.");
 
 	FileAccess::set_big_endian(p_big_endian);
-	f->set_big_endian(p_big_endian);
+	if (f.is_valid()) {
+		f->set_big_endian(p_big_endian);
+	}
 }
 
 Error FileAccessPack::get_error() const {
@@ -376,15 +462,128 @@ bool FileAccessPack::file_exists(const String &p_name) {
 
 void FileAccessPack::close() {
 	f = Ref<FileAccess>();
+	mapped = nullptr;
+	mapped_blocks = nullptr;
+	block_cache.clear();
+	block_buffer.clear();
+	cached_block = -1;
+}
+
+bool FileAccessPack::_open_compressed(const uint8_t *p_mapped, uint64_t p_available) {
+	// Reads from the mapping when there is one, else from f, which must be at the start of the file.
+	uint64_t read_ofs = 0;
+	auto read_data = [&](uint8_t *p_dst, uint64_t p_length) -> bool {
+		if (p_mapped) {
+			if (read_ofs + p_length > p_available) {
+				return false;
+			}
+			memcpy(p_dst, p_mapped + read_ofs, p_length);
+		} else if (f->get_buffer(p_dst, p_length) != p_length) {
+			return false;
+		}
+		read_ofs += p_length;
+		return true;
+	};
+
+	uint8_t header[12];
+	ERR_FAIL_COND_V(!read_data(header, 12), false);
+	const uint32_t mode = decode_uint32(&header[0]);
+	block_size = decode_uint32(&header[4]);
+	const uint32_t block_count = decode_uint32(&header[8]);
+
+	ERR_FAIL_COND_V(mode > Compression::MODE_BROTLI, false);
+	ERR_FAIL_COND_V(block_size == 0 || block_size >= PACK_BLOCK_STORED_RAW, false);
+	ERR_FAIL_COND_V(block_count != (pf.size + block_size - 1) / block_size, false);
+	compression_mode = Compression::Mode(mode);
+
+	Vector<uint8_t> table;
+	table.resize(block_count * 4);
+	ERR_FAIL_COND_V(!read_data(table.ptrw(), table.size()), false);
+
+	block_sizes.resize(block_count);
+	block_offsets.resize(block_count);
+	uint64_t blocks_length = 0;
+	for (uint32_t i = 0; i < block_count; i++) {
+		block_sizes[i] = decode_uint32(&table[i * 4]);
+		block_offsets[i] = blocks_length;
+		blocks_length += block_sizes[i] & ~PACK_BLOCK_STORED_RAW;
+	}
+
+	if (p_mapped) {
+		ERR_FAIL_COND_V(read_ofs + blocks_length > p_available, false);
+		mapped_blocks = p_mapped + read_ofs;
+	} else {
+		blocks_ofs = pf.offset + read_ofs;
+	}
+	compressed = true;
+	return true;
+}
+
+bool FileAccessPack::_load_block(uint32_t p_block) const {
+	if (cached_block == p_block) {
+		return true;
+	}
+	ERR_FAIL_UNSIGNED_INDEX_V(p_block, block_sizes.size(), false);
+
+	const uint32_t stored_size = block_sizes[p_block] & ~PACK_BLOCK_STORED_RAW;
+	const uint64_t block_start = (uint64_t)p_block * block_size;
+	const uint64_t size = MIN((uint64_t)block_size, pf.size - block_start);
+
+	const uint8_t *src = nullptr;
+	if (mapped_blocks) {
+		src = mapped_blocks + block_offsets[p_block];
+	} else {
+		block_buffer.resize(stored_size);
+		f->seek(blocks_ofs + block_offsets[p_block]);
+		ERR_FAIL_COND_V(f->get_buffer(block_buffer.ptr(), stored_size) != stored_size, false);
+		src = block_buffer.ptr();
+	}
+
+	cached_block = -1;
+	block_cache.resize(size);
+	if (block_sizes[p_block] & PACK_BLOCK_STORED_RAW) {
+		ERR_FAIL_COND_V(stored_size != size, false);
+		memcpy(block_cache.ptr(), src, size);
+	} else {
+		const int ret = Compression::decompress(block_cache.ptr(), size, src, stored_size, compression_mode);
+		ERR_FAIL_COND_V_MSG(ret != (int)size, false, "Corrupt compressed block in pack-referenced file '" + String(pf.pack) + "'.");
+	}
+	cached_block = p_block;
+	return true;
 }
 
 FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
-		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
+		pf(p_file) {
+	pos = 0;
+	eof = false;
+	off = pf.offset;
+
+	if (pf.compressed) {
+		ERR_FAIL_COND_MSG(pf.encrypted, "Compressed pack-referenced files can't be encrypted.");
+
+		uint64_t available = 0;
+		const uint8_t *entry = PackedData::get_singleton()->_get_mapped_file(pf, &available);
+		if (!entry) {
+			f = FileAccess::open(pf.pack, FileAccess::READ);
+			ERR_FAIL_COND_MSG(f.is_null(), "Can't open pack-referenced file '" + String(pf.pack) + "'.");
+			f->seek(pf.offset);
+		}
+		if (!_open_compressed(entry, available)) {
+			f = Ref<FileAccess>();
+			ERR_FAIL_MSG("Can't read the block table of compressed pack-referenced file '" + String(pf.pack) + "'.");
+		}
+		return;
+	}
+
+	mapped = PackedData::get_singleton()->_get_mapped_file(pf);
+	if (mapped) {
+		return;
+	}
+
+	f = FileAccess::open(pf.pack, FileAccess::READ);
 	ERR_FAIL_COND_MSG(f.is_null(), "Can't open pack-referenced file '" + String(pf.pack) + "'.");
 
 	f->seek(pf.offset);
-	off = pf.offset;
 
 	if (pf.encrypted) {
 		Ref<FileAccessEncrypted> fae;
@@ -402,8 +601,6 @@ FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFil
 		f = fae;
 		off = 0;
 	}
-	pos = 0;
-	eof = false;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
@@ -31,17 +31,22 @@
 #ifndef FILE_ACCESS_PACK_H
 #define FILE_ACCESS_PACK_H
 
+#include "core/io/compression.h"
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
+#include "core/os/mutex.h"
 #include "core/string/print_string.h"
 #include "core/templates/hash_set.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/rb_map.h"
 
 // Godot's packed file magic header ("GDPC" in ASCII).
 #define PACK_HEADER_MAGIC 0x43504447
 // The current packed file format version number.
-#define PACK_FORMAT_VERSION 2
+#define PACK_FORMAT_VERSION 3
+// The oldest packed file format version that can still be read.
+#define PACK_FORMAT_VERSION_MIN 2
 
 enum PackFlags {
 	PACK_DIR_ENCRYPTED = 1 << 0,
@@ -49,9 +54,16 @@ enum PackFlags {
 };
 
 enum PackFileFlags {
-	PACK_FILE_ENCRYPTED = 1 << 0
+	PACK_FILE_ENCRYPTED = 1 << 0,
+	PACK_FILE_COMPRESSED = 1 << 1,
 };
 
+// Compressed files are split into independently compressed blocks, so they can be read at random:
+// uint32 compression mode, uint32 block size, uint32 block count, the uint32 stored size of each
+// block (with PACK_BLOCK_STORED_RAW set if the block didn't compress), then the blocks themselves.
+#define PACK_COMPRESSED_BLOCK_SIZE 65536
+#define PACK_BLOCK_STORED_RAW 0x80000000
+
 class PackSource;
 
 class PackedData {
@@ -67,6 +79,7 @@ public:
 		uint8_t md5[16];
 		PackSource *src = nullptr;
 		bool encrypted;
+		bool compressed = false;
 	};
 
 private:
@@ -104,13 +117,25 @@ private:
 	PackedDir *root = nullptr;
 
 	static PackedData *singleton;
+	PackedData *previous_singleton = nullptr; // Restored on destruction, so a temporary instance can be used without affecting the global one.
 	bool disabled = false;
 
+	// Packs stay mapped once one of their files has been read through the mapping.
+	struct MappedPack {
+		Ref<FileAccess> file;
+		const uint8_t *data = nullptr;
+		uint64_t length = 0;
+	};
+
+	HashMap<String, MappedPack> mapped_packs;
+	Mutex mapped_packs_mutex;
+
 	void _free_packed_dirs(PackedDir *p_dir);
+	const uint8_t *_get_mapped_file(const PackedFile &p_file, uint64_t *r_available = nullptr);
 
 public:
 	void add_pack_source(PackSource *p_source);
-	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false); // for PackSource
+	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false, bool p_compressed = false); // for PackSource
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -120,6 +145,7 @@ public:
 
 	_FORCE_INLINE_ Ref<FileAccess> try_open_path(const String &p_path);
 	_FORCE_INLINE_ bool has_path(const String &p_path);
+	_FORCE_INLINE_ bool get_path_location(const String &p_path, String &r_pack, uint64_t &r_offset, uint64_t &r_size);
 
 	_FORCE_INLINE_ Ref<DirAccess> try_open_directory(const String &p_path);
 	_FORCE_INLINE_ bool has_directory(const String &p_path);
@@ -132,6 +158,7 @@ class PackSource {
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) = 0;
 	virtual Ref<FileAccess> get_file(const String &p_path, PackedData::PackedFile *p_file) = 0;
+	virtual bool stores_raw_files() const { return false; } // Whether file contents are stored as-is at PackedFile::offset.
 	virtual ~PackSource() {}
 };
 
@@ -139,6 +166,7 @@ class PackedSourcePCK : public PackSource {
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) override;
 	virtual Ref<FileAccess> get_file(const String &p_path, PackedData::PackedFile *p_file) override;
+	virtual bool stores_raw_files() const override { return true; }
 };
 
 class FileAccessPack : public FileAccess {
@@ -149,6 +177,24 @@ class FileAccessPack : public FileAccess {
 	uint64_t off;
 
 	Ref<FileAccess> f;
+	const uint8_t *mapped = nullptr; // If set, reads are served from here instead of f.
+
+	// Compressed files are decompressed one block at a time, keeping the last block around.
+	bool compressed = false;
+	Compression::Mode compression_mode = Compression::MODE_ZSTD;
+	uint32_t block_size = 0;
+	LocalVector<uint32_t> block_sizes;
+	LocalVector<uint64_t> block_offsets;
+	uint64_t blocks_ofs = 0;
+	const uint8_t *mapped_blocks = nullptr;
+	mutable LocalVector<uint8_t> block_cache;
+	mutable LocalVector<uint8_t> block_buffer;
+	mutable int64_t cached_block = -1;
+
+	_FORCE_INLINE_ bool _has_source() const { return mapped || mapped_blocks || f.is_valid(); }
+	bool _open_compressed(const uint8_t *p_mapped, uint64_t p_available);
+	bool _load_block(uint32_t p_block) const;
+
 	virtual Error open_internal(const String &p_path, int p_mode_flags) override;
 	virtual uint64_t _get_modified_time(const String &p_file) override { return 0; }
 	virtual BitField<FileAccess::UnixPermissionFlags> _get_unix_permissions(const String &p_file) override { return 0; }
@@ -172,6 +218,7 @@ public:
 	virtual uint8_t get_8() const override;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const override;
+	virtual const uint8_t *get_mapped_data() const override;
 
 	virtual void set_big_endian(bool p_big_endian) override;
 
@@ -207,6 +254,20 @@ bool PackedData::has_path(const String &p_path) {
 	return files.has(PathMD5(p_path.simplify_path().md5_buffer()));
 }
 
+// Where the bytes of a packed file are stored, for reading them straight from the pack.
+// Fails for encrypted or compressed files, and sources that don't store files as-is.
+bool PackedData::get_path_location(const String &p_path, String &r_pack, uint64_t &r_offset, uint64_t &r_size) {
+	HashMap<PathMD5, PackedFile, PathMD5>::Iterator E = files.find(PathMD5(p_path.simplify_path().md5_buffer()));
+	if (!E || E->value.offset == 0 || E->value.encrypted || E->value.compressed || !E->value.src->stores_raw_files()) {
+		return false;
+	}
+
+	r_pack = E->value.pack;
+	r_offset = E->value.offset;
+	r_size = E->value.size;
+	return true;
+}
+
 bool PackedData::has_directory(const String &p_path) {
 	Ref<DirAccess> da = try_open_directory(p_path);
 	if (da.is_valid()) {
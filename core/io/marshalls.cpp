@@ -759,16 +759,18 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				(*r_len) += 4; // Size of count number.
 			}
 
+			// Every element takes at least 4 bytes, which bounds the allocation below.
+			ERR_FAIL_COND_V(count > len / 4, ERR_INVALID_DATA);
+
 			Array varr;
+			varr.resize(count);
 
 			for (int i = 0; i < count; i++) {
 				int used = 0;
-				Variant v;
-				Error err = decode_variant(v, buf, len, &used, p_allow_objects, p_depth + 1);
+				Error err = decode_variant(varr[i], buf, len, &used, p_allow_objects, p_depth + 1);
 				ERR_FAIL_COND_V_MSG(err != OK, err, "Error when trying to decode Variant.");
 				buf += used;
 				len -= used;
-				varr.push_back(v);
 				if (r_len) {
 					(*r_len) += used;
 				}
@@ -790,10 +792,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 			if (count) {
 				data.resize(count);
-				uint8_t *w = data.ptrw();
-				for (int32_t i = 0; i < count; i++) {
-					w[i] = buf[i];
-				}
+				memcpy(data.ptrw(), buf, count);
 			}
 
 			r_variant = data;
@@ -817,12 +816,15 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			Vector<int32_t> data;
 
 			if (count) {
-				//const int*rbuf=(const int*)buf;
 				data.resize(count);
 				int32_t *w = data.ptrw();
+#ifdef BIG_ENDIAN_ENABLED
 				for (int32_t i = 0; i < count; i++) {
 					w[i] = decode_uint32(&buf[i * 4]);
 				}
+#else
+				memcpy(w, buf, count * sizeof(int32_t));
+#endif
 			}
 			r_variant = Variant(data);
 			if (r_len) {
@@ -841,12 +843,15 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			Vector<int64_t> data;
 
 			if (count) {
-				//const int*rbuf=(const int*)buf;
 				data.resize(count);
 				int64_t *w = data.ptrw();
+#ifdef BIG_ENDIAN_ENABLED
 				for (int64_t i = 0; i < count; i++) {
 					w[i] = decode_uint64(&buf[i * 8]);
 				}
+#else
+				memcpy(w, buf, count * sizeof(int64_t));
+#endif
 			}
 			r_variant = Variant(data);
 			if (r_len) {
@@ -865,12 +870,15 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			Vector<float> data;
 
 			if (count) {
-				//const float*rbuf=(const float*)buf;
 				data.resize(count);
 				float *w = data.ptrw();
+#ifdef BIG_ENDIAN_ENABLED
 				for (int32_t i = 0; i < count; i++) {
 					w[i] = decode_float(&buf[i * 4]);
 				}
+#else
+				memcpy(w, buf, count * sizeof(float));
+#endif
 			}
 			r_variant = data;
 
@@ -892,9 +900,13 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			if (count) {
 				data.resize(count);
 				double *w = data.ptrw();
+#ifdef BIG_ENDIAN_ENABLED
 				for (int64_t i = 0; i < count; i++) {
 					w[i] = decode_double(&buf[i * 8]);
 				}
+#else
+				memcpy(w, buf, count * sizeof(double));
+#endif
 			}
 			r_variant = data;
 
@@ -911,18 +923,21 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			buf += 4;
 			len -= 4;
 
+			// Every string takes at least 4 bytes, which bounds the allocation below.
+			ERR_FAIL_COND_V(count < 0 || count > len / 4, ERR_INVALID_DATA);
+
 			if (r_len) {
 				(*r_len) += 4; // Size of count number.
 			}
 
+			strings.resize(count);
+			String *w = strings.ptrw();
+
 			for (int32_t i = 0; i < count; i++) {
-				String str;
-				Error err = _decode_string(buf, len, r_len, str);
+				Error err = _decode_string(buf, len, r_len, w[i]);
 				if (err) {
 					return err;
 				}
-
-				strings.push_back(str);
 			}
 
 			r_variant = strings;
@@ -1649,9 +1664,15 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_uint32(datalen, buf);
 				buf += 4;
 				const int32_t *r = data.ptr();
+#ifdef BIG_ENDIAN_ENABLED
 				for (int32_t i = 0; i < datalen; i++) {
 					encode_uint32(r[i], &buf[i * datasize]);
 				}
+#else
+				if (datalen) {
+					memcpy(buf, r, datalen * datasize);
+				}
+#endif
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1666,9 +1687,15 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_uint32(datalen, buf);
 				buf += 4;
 				const int64_t *r = data.ptr();
+#ifdef BIG_ENDIAN_ENABLED
 				for (int64_t i = 0; i < datalen; i++) {
 					encode_uint64(r[i], &buf[i * datasize]);
 				}
+#else
+				if (datalen) {
+					memcpy(buf, r, datalen * datasize);
+				}
+#endif
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1683,9 +1710,15 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_uint32(datalen, buf);
 				buf += 4;
 				const float *r = data.ptr();
+#ifdef BIG_ENDIAN_ENABLED
 				for (int i = 0; i < datalen; i++) {
 					encode_float(r[i], &buf[i * datasize]);
 				}
+#else
+				if (datalen) {
+					memcpy(buf, r, datalen * datasize);
+				}
+#endif
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1700,9 +1733,15 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_uint32(datalen, buf);
 				buf += 4;
 				const double *r = data.ptr();
+#ifdef BIG_ENDIAN_ENABLED
 				for (int i = 0; i < datalen; i++) {
 					encode_double(r[i], &buf[i * datasize]);
 				}
+#else
+				if (datalen) {
+					memcpy(buf, r, datalen * datasize);
+				}
+#endif
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1822,6 +1861,117 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 	return OK;
 }
 
+// Returns nullptr, leaving the buffer untouched, if the reservation would take it past p_max_len.
+static inline uint8_t *_encode_reserve(Vector<uint8_t> &r_buffer, int &r_len, int p_size, int p_max_len) {
+	if (p_size > p_max_len - r_len) {
+		return nullptr;
+	}
+	int needed = r_len + p_size;
+	if (needed > r_buffer.size()) {
+		r_buffer.resize(MAX(needed, MIN(int(next_power_of_2(needed)), p_max_len)));
+	}
+	uint8_t *w = r_buffer.ptrw() + r_len;
+	r_len = needed;
+	return w;
+}
+
+static Error _encode_string(const CharString &p_utf8, int p_extra, Vector<uint8_t> &r_buffer, int &r_len, int p_max_len) {
+	int slen = p_utf8.length() + p_extra;
+	int pad = (4 - slen % 4) % 4;
+	uint8_t *w = _encode_reserve(r_buffer, r_len, 4 + slen + pad, p_max_len);
+	if (!w) {
+		return ERR_OUT_OF_MEMORY;
+	}
+	encode_uint32(slen, w);
+	memcpy(w + 4, p_utf8.get_data(), slen);
+	memset(w + 4 + slen, 0, pad);
+	return OK;
+}
+
+Error encode_variant(const Variant &p_variant, Vector<uint8_t> &r_buffer, int &r_len, bool p_full_objects, int p_depth, int p_max_len) {
+	ERR_FAIL_COND_V_MSG(p_depth > Variant::MAX_RECURSION_DEPTH, ERR_OUT_OF_MEMORY, "Potential infinite recursion detected. Bailing.");
+	ERR_FAIL_COND_V(r_len < 0 || r_len % 4, ERR_INVALID_PARAMETER);
+
+	// Containers and strings are written in a single pass, growing the buffer as needed.
+	// Everything else has a cheap size pass and goes through the fixed buffer encoder.
+	// Running out of room is left for the caller to report, so nested failures return quietly.
+	switch (p_variant.get_type()) {
+		case Variant::STRING:
+		case Variant::STRING_NAME: {
+			uint8_t *w = _encode_reserve(r_buffer, r_len, 4, p_max_len);
+			if (!w) {
+				return ERR_OUT_OF_MEMORY;
+			}
+			encode_uint32(p_variant.get_type(), w);
+			return _encode_string(String(p_variant).utf8(), 0, r_buffer, r_len, p_max_len);
+		} break;
+		case Variant::PACKED_STRING_ARRAY: {
+			const Vector<String> data = p_variant;
+			uint8_t *w = _encode_reserve(r_buffer, r_len, 8, p_max_len);
+			if (!w) {
+				return ERR_OUT_OF_MEMORY;
+			}
+			encode_uint32(Variant::PACKED_STRING_ARRAY, w);
+			encode_uint32(data.size(), w + 4);
+			for (const String &E : data) {
+				// Packed strings include the terminating null character.
+				Error err = _encode_string(E.utf8(), 1, r_buffer, r_len, p_max_len);
+				if (err != OK) {
+					return err;
+				}
+			}
+		} break;
+		case Variant::DICTIONARY: {
+			const Dictionary d = p_variant;
+			uint8_t *w = _encode_reserve(r_buffer, r_len, 8, p_max_len);
+			if (!w) {
+				return ERR_OUT_OF_MEMORY;
+			}
+			encode_uint32(Variant::DICTIONARY, w);
+			encode_uint32(uint32_t(d.size()), w + 4);
+			for (const Variant *key = d.next(); key; key = d.next(key)) {
+				Error err = encode_variant(*key, r_buffer, r_len, p_full_objects, p_depth + 1, p_max_len);
+				if (err != OK) {
+					return err;
+				}
+				err = encode_variant(d[*key], r_buffer, r_len, p_full_objects, p_depth + 1, p_max_len);
+				if (err != OK) {
+					return err;
+				}
+			}
+		} break;
+		case Variant::ARRAY: {
+			const Array v = p_variant;
+			uint8_t *w = _encode_reserve(r_buffer, r_len, 8, p_max_len);
+			if (!w) {
+				return ERR_OUT_OF_MEMORY;
+			}
+			encode_uint32(Variant::ARRAY, w);
+			encode_uint32(uint32_t(v.size()), w + 4);
+			for (int i = 0; i < v.size(); i++) {
+				Error err = encode_variant(v[i], r_buffer, r_len, p_full_objects, p_depth + 1, p_max_len);
+				if (err != OK) {
+					return err;
+				}
+			}
+		} break;
+		default: {
+			int len;
+			Error err = encode_variant(p_variant, nullptr, len, p_full_objects, p_depth);
+			ERR_FAIL_COND_V(err, err);
+			ERR_FAIL_COND_V(len % 4, ERR_BUG);
+			int ofs = r_len;
+			if (!_encode_reserve(r_buffer, r_len, len, p_max_len)) {
+				return ERR_OUT_OF_MEMORY;
+			}
+			err = encode_variant(p_variant, r_buffer.ptrw() + ofs, len, p_full_objects, p_depth);
+			ERR_FAIL_COND_V(err, err);
+		} break;
+	}
+
+	return OK;
+}
+
 Vector<float> vector3_to_float32_array(const Vector3 *vecs, size_t count) {
 	// We always allocate a new array, and we don't memcpy.
 	// We also don't consider returning a pointer to the passed vectors when sizeof(real_t) == 4.
@@ -214,6 +214,10 @@ public:
 
 Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = nullptr, bool p_allow_objects = false, int p_depth = 0);
 Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects = false, int p_depth = 0);
+// Appends the encoded variant at offset r_len of r_buffer, which grows as needed, and advances r_len.
+// The buffer may end up larger than r_len; only the first r_len bytes are meaningful.
+// Fails with ERR_OUT_OF_MEMORY, without growing the buffer past it, if the encoding would exceed p_max_len.
+Error encode_variant(const Variant &p_variant, Vector<uint8_t> &r_buffer, int &r_len, bool p_full_objects = false, int p_depth = 0, int p_max_len = INT32_MAX);
 
 Vector<float> vector3_to_float32_array(const Vector3 *vecs, size_t count);
 
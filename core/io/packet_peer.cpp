@@ -89,28 +89,17 @@ Error PacketPeer::get_var(Variant &r_variant, bool p_allow_objects) {
 }
 
 Error PacketPeer::put_var(const Variant &p_packet, bool p_full_objects) {
-	int len;
-	Error err = encode_variant(p_packet, nullptr, len, p_full_objects); // compute len first
-	if (err) {
-		return err;
-	}
+	// Encode in a single pass, reusing (and growing) the encode buffer, which is never grown past its maximum size.
+	int len = 0;
+	Error err = encode_variant(p_packet, encode_buffer, len, p_full_objects, 0, encode_buffer_max_size);
+	ERR_FAIL_COND_V_MSG(err == ERR_OUT_OF_MEMORY, err, "Failed to encode variant, encode size is bigger then encode_buffer_max_size. Consider raising it via 'set_encode_buffer_max_size'.");
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Error when trying to encode Variant.");
 
 	if (len == 0) {
 		return OK;
 	}
 
-	ERR_FAIL_COND_V_MSG(len > encode_buffer_max_size, ERR_OUT_OF_MEMORY, "Failed to encode variant, encode size is bigger then encode_buffer_max_size. Consider raising it via 'set_encode_buffer_max_size'.");
-
-	if (unlikely(encode_buffer.size() < len)) {
-		encode_buffer.resize(0); // Avoid realloc
-		encode_buffer.resize(next_power_of_2(len));
-	}
-
-	uint8_t *w = encode_buffer.ptrw();
-	err = encode_variant(p_packet, w, len, p_full_objects);
-	ERR_FAIL_COND_V_MSG(err != OK, err, "Error when trying to encode Variant.");
-
-	return put_packet(w, len);
+	return put_packet(encode_buffer.ptr(), len);
 }
 
 Variant PacketPeer::_bnd_get_var(bool p_allow_objects) {
@@ -31,9 +31,12 @@
 #include "pck_packer.h"
 
 #include "core/crypto/crypto_core.h"
+#include "core/io/compression.h"
 #include "core/io/file_access.h"
 #include "core/io/file_access_encrypted.h"
 #include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
+#include "core/io/marshalls.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/version.h"
 
 static int _get_pad(int p_alignment, int p_n) {
@@ -49,6 +52,7 @@ static int _get_pad(int p_alignment, int p_n) {
 void PCKPacker::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pck_start", "pck_name", "alignment", "key", "encrypt_directory"), &PCKPacker::pck_start, DEFVAL(32), DEFVAL("0000000000000000000000000000000000000000000000000000000000000000"), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path", "encrypt"), &PCKPacker::add_file, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("add_file_compressed", "pck_path", "source_path", "compression_mode"), &PCKPacker::add_file_compressed, DEFVAL(FileAccess::COMPRESSION_ZSTD));
 	ClassDB::bind_method(D_METHOD("flush", "verbose"), &PCKPacker::flush, DEFVAL(false));
 }
 
@@ -101,12 +105,20 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment, const String &
 	file->store_32(pack_flags); // flags
 
 	files.clear();
-	ofs = 0;
 
 	return OK;
 }
 
 Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encrypt) {
+	return _add_file(p_file, p_src, p_encrypt, false, FileAccess::COMPRESSION_ZSTD);
+}
+
+Error PCKPacker::add_file_compressed(const String &p_file, const String &p_src, FileAccess::CompressionMode p_compression_mode) {
+	ERR_FAIL_COND_V_MSG(p_compression_mode < FileAccess::COMPRESSION_FASTLZ || p_compression_mode >= FileAccess::COMPRESSION_BROTLI, ERR_INVALID_PARAMETER, "Unsupported compression mode.");
+	return _add_file(p_file, p_src, false, true, p_compression_mode);
+}
+
+Error PCKPacker::_add_file(const String &p_file, const String &p_src, bool p_encrypt, bool p_compress, FileAccess::CompressionMode p_compression_mode) {
 	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
 
 	Ref<FileAccess> f = FileAccess::open(p_src, FileAccess::READ);
@@ -119,7 +131,6 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encr
 	// symbols in them still match to the MD5 hash for the saved path.
 	pf.path = p_file.simplify_path();
 	pf.src_path = p_src;
-	pf.ofs = ofs;
 	pf.size = f->get_length();
 
 	Vector<uint8_t> data = FileAccess::get_file_as_bytes(p_src);
@@ -132,47 +143,68 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encr
 		}
 	}
 	pf.encrypted = p_encrypt;
-
-	uint64_t _size = pf.size;
-	if (p_encrypt) { // Add encryption overhead.
-		if (_size % 16) { // Pad to encryption block size.
-			_size += 16 - (_size % 16);
-		}
-		_size += 16; // hash
-		_size += 8; // data size
-		_size += 16; // iv
-	}
-
-	int pad = _get_pad(alignment, ofs + _size);
-	ofs = ofs + _size + pad;
+	pf.compressed = p_compress;
+	pf.compression_mode = p_compression_mode;
 
 	files.push_back(pf);
 
 	return OK;
 }
 
-Error PCKPacker::flush(bool p_verbose) {
-	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
+void PCKPacker::_compress_file(uint32_t p_index, File *p_files) {
+	File &pf = p_files[p_index];
+	if (!pf.compressed) {
+		return;
+	}
 
-	int64_t file_base_ofs = file->get_position();
-	file->store_64(0); // files base
+	// Left empty on failure, flush() reports it.
+	Vector<uint8_t> data = FileAccess::get_file_as_bytes(pf.src_path);
+	if ((uint64_t)data.size() != pf.size) {
+		return;
+	}
 
-	for (int i = 0; i < 16; i++) {
-		file->store_32(0); // reserved
+	const Compression::Mode mode = Compression::Mode(pf.compression_mode);
+	const uint32_t block_count = (pf.size + PACK_COMPRESSED_BLOCK_SIZE - 1) / PACK_COMPRESSED_BLOCK_SIZE;
+	const uint64_t table_size = 12 + (uint64_t)block_count * 4;
+
+	Vector<uint8_t> out;
+	out.resize(table_size + (uint64_t)block_count * MAX(Compression::get_max_compressed_buffer_size(PACK_COMPRESSED_BLOCK_SIZE, mode), PACK_COMPRESSED_BLOCK_SIZE));
+	uint8_t *w = out.ptrw();
+	encode_uint32(mode, &w[0]);
+	encode_uint32(PACK_COMPRESSED_BLOCK_SIZE, &w[4]);
+	encode_uint32(block_count, &w[8]);
+
+	uint64_t out_ofs = table_size;
+	for (uint32_t i = 0; i < block_count; i++) {
+		const uint64_t start = (uint64_t)i * PACK_COMPRESSED_BLOCK_SIZE;
+		const int size = MIN((uint64_t)PACK_COMPRESSED_BLOCK_SIZE, pf.size - start);
+
+		int stored = Compression::compress(&w[out_ofs], data.ptr() + start, size, mode);
+		uint32_t block_entry = stored;
+		if (stored <= 0 || stored >= size) {
+			// Not worth decompressing, store the block as-is.
+			memcpy(&w[out_ofs], data.ptr() + start, size);
+			stored = size;
+			block_entry = size | PACK_BLOCK_STORED_RAW;
+		}
+		encode_uint32(block_entry, &w[12 + i * 4]);
+		out_ofs += stored;
 	}
 
-	// write the index
-	file->store_32(files.size());
+	out.resize(out_ofs);
+	pf.compressed_data = out;
+}
 
+void PCKPacker::_store_directory() {
 	Ref<FileAccessEncrypted> fae;
 	Ref<FileAccess> fhead = file;
 
 	if (enc_dir) {
 		fae.instantiate();
-		ERR_FAIL_COND_V(fae.is_null(), ERR_CANT_CREATE);
+		ERR_FAIL_COND(fae.is_null());
 
 		Error err = fae->open_and_parse(file, key, FileAccessEncrypted::MODE_WRITE_AES256, false);
-		ERR_FAIL_COND_V(err != OK, ERR_CANT_CREATE);
+		ERR_FAIL_COND(err != OK);
 
 		fhead = fae;
 	}
@@ -195,14 +227,31 @@ Error PCKPacker::flush(bool p_verbose) {
 		if (files[i].encrypted) {
 			flags |= PACK_FILE_ENCRYPTED;
 		}
+		if (files[i].compressed) {
+			flags |= PACK_FILE_COMPRESSED;
+		}
 		fhead->store_32(flags);
 	}
+}
+
+Error PCKPacker::flush(bool p_verbose) {
+	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
+
+	int64_t file_base_ofs = file->get_position();
+	file->store_64(0); // files base
 
-	if (fae.is_valid()) {
-		fhead.unref();
-		fae.unref();
+	for (int i = 0; i < 16; i++) {
+		file->store_32(0); // reserved
 	}
 
+	// write the index
+	file->store_32(files.size());
+
+	// Offsets depend on the compressed sizes, so the directory is stored
+	// again with the right values once all the files have been written.
+	int64_t directory_ofs = file->get_position();
+	_store_directory();
+
 	int header_padding = _get_pad(alignment, file->get_position());
 	for (int i = 0; i < header_padding; i++) {
 		file->store_8(0);
@@ -216,30 +265,67 @@ Error PCKPacker::flush(bool p_verbose) {
 	const uint32_t buf_max = 65536;
 	uint8_t *buf = memnew_arr(uint8_t, buf_max);
 
-	int count = 0;
-	for (int i = 0; i < files.size(); i++) {
-		Ref<FileAccess> src = FileAccess::open(files[i].src_path, FileAccess::READ);
-		uint64_t to_write = files[i].size;
-
-		Ref<FileAccess> ftmp = file;
-		if (files[i].encrypted) {
-			fae.instantiate();
-			ERR_FAIL_COND_V(fae.is_null(), ERR_CANT_CREATE);
+	// Compressed files are compressed in parallel, in batches that bound how much is held in memory.
+	const uint64_t batch_max_size = 64 * 1024 * 1024;
+	const int file_num = files.size();
+	File *files_ptr = files.ptrw();
+	Ref<FileAccessEncrypted> fae;
 
-			Error err = fae->open_and_parse(file, key, FileAccessEncrypted::MODE_WRITE_AES256, false);
-			ERR_FAIL_COND_V(err != OK, ERR_CANT_CREATE);
-			ftmp = fae;
+	int batch_end = 0;
+	for (int i = 0; i < file_num; i++) {
+		if (i == batch_end) {
+			uint64_t batch_size = 0;
+			while (batch_end < file_num) {
+				const File &next = files[batch_end];
+				if (next.compressed) {
+					if (batch_size > 0 && batch_size + next.size > batch_max_size) {
+						break;
+					}
+					batch_size += next.size;
+				}
+				batch_end++;
+			}
+			if (batch_size > 0) {
+				WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &PCKPacker::_compress_file, files_ptr + i, batch_end - i, -1, true, SNAME("PCKPacker"));
+				WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+			}
 		}
 
-		while (to_write > 0) {
-			uint64_t read = src->get_buffer(buf, MIN(to_write, buf_max));
-			ftmp->store_buffer(buf, read);
-			to_write -= read;
-		}
+		File &pf = files_ptr[i];
+		pf.ofs = file->get_position() - file_base;
+
+		if (pf.compressed) {
+			if (pf.compressed_data.is_empty()) {
+				memdelete_arr(buf);
+				file.unref();
+				ERR_FAIL_V_MSG(ERR_FILE_CANT_READ, "Can't compress file: " + pf.src_path + ".");
+			}
+			file->store_buffer(pf.compressed_data.ptr(), pf.compressed_data.size());
+			pf.compressed_data.clear();
+		} else {
+			Ref<FileAccess> src = FileAccess::open(pf.src_path, FileAccess::READ);
+			uint64_t to_write = pf.size;
+
+			Ref<FileAccess> ftmp = file;
+			if (pf.encrypted) {
+				fae.instantiate();
+				ERR_FAIL_COND_V(fae.is_null(), ERR_CANT_CREATE);
+
+				Error err = fae->open_and_parse(file, key, FileAccessEncrypted::MODE_WRITE_AES256, false);
+				ERR_FAIL_COND_V(err != OK, ERR_CANT_CREATE);
+				ftmp = fae;
+			}
+
+			while (to_write > 0) {
+				uint64_t read = src->get_buffer(buf, MIN(to_write, buf_max));
+				ftmp->store_buffer(buf, read);
+				to_write -= read;
+			}
 
-		if (fae.is_valid()) {
-			ftmp.unref();
-			fae.unref();
+			if (fae.is_valid()) {
+				ftmp.unref();
+				fae.unref();
+			}
 		}
 
 		int pad = _get_pad(alignment, file->get_position());
@@ -247,13 +333,15 @@ Error PCKPacker::flush(bool p_verbose) {
 			file->store_8(0);
 		}
 
-		count += 1;
-		const int file_num = files.size();
 		if (p_verbose && (file_num > 0)) {
-			print_line(vformat("[%d/%d - %d%%] PCKPacker flush: %s -> %s", count, file_num, float(count) / file_num * 100, files[i].src_path, files[i].path));
+			print_line(vformat("[%d/%d - %d%%] PCKPacker flush: %s -> %s", i + 1, file_num, float(i + 1) / file_num * 100, pf.src_path, pf.path));
 		}
 	}
 
+	// Store the directory again now that all offsets are known, its size is unchanged.
+	file->seek(directory_ofs);
+	_store_directory();
+
 	file.unref();
 	memdelete_arr(buf);
 
@@ -31,16 +31,14 @@
 #ifndef PCK_PACKER_H
 #define PCK_PACKER_H
 
+#include "core/io/file_access.h"
 #include "core/object/ref_counted.h"
 
-class FileAccess;
-
 class PCKPacker : public RefCounted {
 	GDCLASS(PCKPacker, RefCounted);
 
 	Ref<FileAccess> file;
 	int alignment = 0;
-	uint64_t ofs = 0;
 
 	Vector<uint8_t> key;
 	bool enc_dir = false;
@@ -53,13 +51,21 @@ class PCKPacker : public RefCounted {
 		uint64_t ofs = 0;
 		uint64_t size = 0;
 		bool encrypted = false;
+		bool compressed = false;
+		FileAccess::CompressionMode compression_mode = FileAccess::COMPRESSION_ZSTD;
 		Vector<uint8_t> md5;
+		Vector<uint8_t> compressed_data; // Only held while flushing.
 	};
 	Vector<File> files;
 
+	Error _add_file(const String &p_file, const String &p_src, bool p_encrypt, bool p_compress, FileAccess::CompressionMode p_compression_mode);
+	void _compress_file(uint32_t p_index, File *p_files);
+	void _store_directory();
+
 public:
 	Error pck_start(const String &p_file, int p_alignment = 32, const String &p_key = "0000000000000000000000000000000000000000000000000000000000000000", bool p_encrypt_directory = false);
 	Error add_file(const String &p_file, const String &p_src, bool p_encrypt = false);
+	Error add_file_compressed(const String &p_file, const String &p_src, FileAccess::CompressionMode p_compression_mode = FileAccess::COMPRESSION_ZSTD);
 	Error flush(bool p_verbose = false);
 
 	PCKPacker() {}
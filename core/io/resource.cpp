@@ -566,6 +566,12 @@ void Resource::_bind_methods() {
 	GDVIRTUAL_BIND(_setup_local_to_scene);
 }
 
+void Resource::_notification(int p_what) {
+	if (p_what == NOTIFICATION_PREDELETE && ResourceCache::_retain_released(this)) {
+		cancel_free();
+	}
+}
+
 Resource::Resource() :
 		remapped_list(this) {}
 
@@ -587,7 +593,20 @@ Mutex ResourceCache::lock;
 RWLock ResourceCache::path_cache_lock;
 #endif
 
+LRUCache<String, ResourceCache::Retained> ResourceCache::retained(INT32_MAX); // Bounded by size, not count.
+HashMap<StringName, uint64_t> ResourceCache::retained_size_by_type;
+uint64_t ResourceCache::retained_size = 0;
+SafeNumeric<uint64_t> ResourceCache::retained_budget;
+SafeNumeric<uint64_t> ResourceCache::hit_count;
+SafeNumeric<uint64_t> ResourceCache::miss_count;
+SafeNumeric<uint64_t> ResourceCache::eviction_count;
+thread_local Resource *ResourceCache::releasing = nullptr;
+void (*ResourceCache::retained_type_added_func)(const StringName &p_type) = nullptr;
+
 void ResourceCache::clear() {
+	retained_budget.set(0);
+	clear_retained();
+
 	if (!resources.is_empty()) {
 		if (OS::get_singleton()->is_stdout_verbose()) {
 			ERR_PRINT(vformat("%d resources still in use at exit.", resources.size()));
@@ -677,3 +696,215 @@ int ResourceCache::get_cached_resource_count() {
 
 	return rc;
 }
+
+static uint64_t _estimate_variant_size(const Variant &p_value, int p_depth) {
+	switch (p_value.get_type()) {
+		case Variant::STRING:
+		case Variant::STRING_NAME:
+		case Variant::NODE_PATH:
+			return sizeof(Variant) + String(p_value).length() * sizeof(char32_t);
+		case Variant::PACKED_BYTE_ARRAY:
+			return sizeof(Variant) + PackedByteArray(p_value).size();
+		case Variant::PACKED_INT32_ARRAY:
+			return sizeof(Variant) + PackedInt32Array(p_value).size() * sizeof(int32_t);
+		case Variant::PACKED_INT64_ARRAY:
+			return sizeof(Variant) + PackedInt64Array(p_value).size() * sizeof(int64_t);
+		case Variant::PACKED_FLOAT32_ARRAY:
+			return sizeof(Variant) + PackedFloat32Array(p_value).size() * sizeof(float);
+		case Variant::PACKED_FLOAT64_ARRAY:
+			return sizeof(Variant) + PackedFloat64Array(p_value).size() * sizeof(double);
+		case Variant::PACKED_VECTOR2_ARRAY:
+			return sizeof(Variant) + PackedVector2Array(p_value).size() * sizeof(Vector2);
+		case Variant::PACKED_VECTOR3_ARRAY:
+			return sizeof(Variant) + PackedVector3Array(p_value).size() * sizeof(Vector3);
+		case Variant::PACKED_COLOR_ARRAY:
+			return sizeof(Variant) + PackedColorArray(p_value).size() * sizeof(Color);
+		case Variant::PACKED_STRING_ARRAY: {
+			uint64_t size = sizeof(Variant);
+			for (const String &E : PackedStringArray(p_value)) {
+				size += sizeof(String) + E.length() * sizeof(char32_t);
+			}
+			return size;
+		}
+		case Variant::ARRAY: {
+			const Array array = p_value;
+			if (p_depth >= 8) {
+				return sizeof(Variant) * (array.size() + 1);
+			}
+			uint64_t size = sizeof(Variant);
+			for (int i = 0; i < array.size(); i++) {
+				size += _estimate_variant_size(array[i], p_depth + 1);
+			}
+			return size;
+		}
+		case Variant::DICTIONARY: {
+			const Dictionary dictionary = p_value;
+			if (p_depth >= 8) {
+				return sizeof(Variant) * (dictionary.size() * 2 + 1);
+			}
+			uint64_t size = sizeof(Variant);
+			const Variant *key = nullptr;
+			while ((key = dictionary.next(key))) {
+				size += _estimate_variant_size(*key, p_depth + 1) + _estimate_variant_size(dictionary[*key], p_depth + 1);
+			}
+			return size;
+		}
+		default:
+			// Resources referenced by this one are retained, and counted, on their own.
+			return sizeof(Variant);
+	}
+}
+
+// Only an approximation of the memory used: what's held elsewhere (e.g. by the RenderingServer) isn't known.
+uint64_t ResourceCache::_estimate_size(const Resource *p_resource) {
+	uint64_t size = sizeof(*p_resource);
+	List<PropertyInfo> properties;
+	p_resource->get_property_list(&properties);
+	for (const PropertyInfo &E : properties) {
+		if (E.usage & PROPERTY_USAGE_STORAGE) {
+			size += _estimate_variant_size(p_resource->get(E.name), 0);
+		}
+	}
+	return size;
+}
+
+void ResourceCache::_evict_retained(uint64_t p_budget, LocalVector<Ref<Resource>> &r_released) {
+	Retained evicted;
+	while (retained_size > p_budget && retained.pop_least_recent(&evicted)) {
+		retained_size -= evicted.size;
+		retained_size_by_type[evicted.type] -= evicted.size;
+		eviction_count.increment();
+		// Released by the caller, once the lock is no longer held.
+		r_released.push_back(evicted.resource);
+	}
+}
+
+void ResourceCache::_release_evicted(LocalVector<Ref<Resource>> &r_released) {
+	Resource *previous = releasing;
+	for (Ref<Resource> &E : r_released) {
+		// Freed if that was the last reference, instead of being retained again.
+		releasing = E.ptr();
+		E.unref();
+	}
+	releasing = previous;
+	r_released.clear();
+}
+
+// Called when the last reference to a resource is released. Returns whether the cache took it back
+// instead of letting it be freed.
+bool ResourceCache::_retain_released(Resource *p_resource) {
+	const uint64_t budget = retained_budget.get();
+	if (budget == 0 || p_resource == releasing || p_resource->is_built_in()) {
+		return false;
+	}
+	if (p_resource->get_script_instance() || p_resource->_get_extension()) {
+		// They were already told about their deletion.
+		return false;
+	}
+
+	const uint64_t size = _estimate_size(p_resource);
+	if (size > budget) {
+		return false;
+	}
+
+	const StringName type = p_resource->get_class_name();
+	LocalVector<Ref<Resource>> released;
+	bool new_type = false;
+
+	lock.lock();
+
+	Resource **cached = resources.getptr(p_resource->path_cache);
+	if (!cached || *cached != p_resource) {
+		// Found with no references left meanwhile, and dropped from the cache.
+		lock.unlock();
+		return false;
+	}
+
+	p_resource->_revive_reference();
+	Retained entry;
+	entry.resource = Ref<Resource>(p_resource);
+	p_resource->unreference(); // Only the cache references it now.
+	entry.type = type;
+	entry.size = size;
+	const Retained *previous = retained.getptr(p_resource->path_cache);
+	if (previous) {
+		// Another resource that took over the path.
+		retained_size -= previous->size;
+		retained_size_by_type[previous->type] -= previous->size;
+		released.push_back(previous->resource);
+	}
+	retained.insert(p_resource->path_cache, entry);
+	retained_size += size;
+
+	uint64_t *type_size = retained_size_by_type.getptr(type);
+	if (type_size) {
+		*type_size += size;
+	} else {
+		retained_size_by_type.insert(type, size);
+		new_type = true;
+	}
+
+	_evict_retained(budget, released);
+
+	lock.unlock();
+
+	_release_evicted(released);
+
+	if (new_type && retained_type_added_func) {
+		retained_type_added_func(type);
+	}
+	return true;
+}
+
+void ResourceCache::_notify_hit(const String &p_path) {
+	hit_count.increment();
+	if (retained_budget.get() == 0) {
+		return;
+	}
+
+	// In use again, so it's retained again only once released.
+	Ref<Resource> reused;
+	{
+		MutexLock mutex_lock(lock);
+		const Retained *entry = retained.getptr(p_path);
+		if (!entry) {
+			return;
+		}
+		reused = entry->resource;
+		retained_size -= entry->size;
+		retained_size_by_type[entry->type] -= entry->size;
+		retained.erase(p_path);
+	}
+}
+
+void ResourceCache::set_retained_budget(uint64_t p_bytes) {
+	LocalVector<Ref<Resource>> released;
+
+	lock.lock();
+	retained_budget.set(p_bytes);
+	_evict_retained(p_bytes, released);
+	lock.unlock();
+
+	_release_evicted(released);
+}
+
+void ResourceCache::clear_retained() {
+	LocalVector<Ref<Resource>> released;
+
+	lock.lock();
+	_evict_retained(0, released);
+	lock.unlock();
+
+	_release_evicted(released);
+}
+
+uint64_t ResourceCache::get_retained_size() {
+	MutexLock mutex_lock(lock);
+	return retained_size;
+}
+
+uint64_t ResourceCache::get_retained_size_for_type(const StringName &p_type) {
+	MutexLock mutex_lock(lock);
+	const uint64_t *type_size = retained_size_by_type.getptr(p_type);
+	return type_size ? *type_size : 0;
+}
@@ -35,6 +35,7 @@
 #include "core/object/class_db.h"
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
+#include "core/templates/lru.h"
 #include "core/templates/safe_refcount.h"
 #include "core/templates/self_list.h"
 
@@ -78,6 +79,7 @@ private:
 	void _find_sub_resources(const Variant &p_variant, HashSet<Ref<Resource>> &p_resources_found);
 
 protected:
+	void _notification(int p_what);
 	virtual void _resource_path_changed();
 	static void _bind_methods();
 
@@ -165,11 +167,45 @@ class ResourceCache {
 	static void clear();
 	friend void register_core_types();
 
+	// Cached resources can be retained when everything else releases them, up to a size budget, so
+	// they stay cached for a while. Sizes are estimated from the data the resources store.
+	struct Retained {
+		Ref<Resource> resource;
+		StringName type;
+		uint64_t size = 0;
+	};
+	static LRUCache<String, Retained> retained;
+	static HashMap<StringName, uint64_t> retained_size_by_type;
+	static uint64_t retained_size;
+	static SafeNumeric<uint64_t> retained_budget;
+	static SafeNumeric<uint64_t> hit_count;
+	static SafeNumeric<uint64_t> miss_count;
+	static SafeNumeric<uint64_t> eviction_count;
+	static thread_local Resource *releasing;
+
+	static uint64_t _estimate_size(const Resource *p_resource);
+	static void _evict_retained(uint64_t p_budget, LocalVector<Ref<Resource>> &r_released);
+	static void _release_evicted(LocalVector<Ref<Resource>> &r_released);
+	static bool _retain_released(Resource *p_resource);
+	static void _notify_hit(const String &p_path);
+	static void _notify_miss() { miss_count.increment(); }
+
 public:
+	static void (*retained_type_added_func)(const StringName &p_type); // Used by Performance.
+
 	static bool has(const String &p_path);
 	static Ref<Resource> get_ref(const String &p_path);
 	static void get_cached_resources(List<Ref<Resource>> *p_resources);
 	static int get_cached_resource_count();
+
+	static void set_retained_budget(uint64_t p_bytes);
+	static uint64_t get_retained_budget() { return retained_budget.get(); }
+	static void clear_retained();
+	static uint64_t get_retained_size();
+	static uint64_t get_retained_size_for_type(const StringName &p_type);
+	static uint64_t get_hit_count() { return hit_count.get(); }
+	static uint64_t get_miss_count() { return miss_count.get(); }
+	static uint64_t get_eviction_count() { return eviction_count.get(); }
 };
 
 #endif // RESOURCE_H
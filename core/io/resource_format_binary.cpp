@@ -93,9 +93,12 @@ enum {
 	// Version 3: changed nodepath encoding.
 	// Version 4: new string ID for ext/subresources, breaks forward compat.
 	// Version 5: Ability to store script class in the header.
-	FORMAT_VERSION = 5,
+	// Version 6: Bulk packed array payloads are aligned, preceded by their padding length.
+	FORMAT_VERSION = 6,
 	FORMAT_VERSION_CAN_RENAME_DEPS = 1,
 	FORMAT_VERSION_NO_NODEPATH_PROPERTY = 3,
+	FORMAT_VERSION_ALIGNED_PACKED_ARRAYS = 6,
+	PACKED_ARRAY_ALIGNMENT = 16,
 };
 
 void ResourceLoaderBinary::_advance_padding(uint32_t p_len) {
@@ -107,6 +110,20 @@ void ResourceLoaderBinary::_advance_padding(uint32_t p_len) {
 	}
 }
 
+Error ResourceLoaderBinary::_advance_alignment() {
+	if (ver_format < FORMAT_VERSION_ALIGNED_PACKED_ARRAYS) {
+		return OK;
+	}
+	// The padding length is stored rather than derived from the position,
+	// so files whose header was rewritten (e.g. renamed dependencies) stay readable.
+	uint32_t pad = f->get_32();
+	ERR_FAIL_COND_V_MSG(pad >= PACKED_ARRAY_ALIGNMENT, ERR_FILE_CORRUPT, vformat("Invalid packed array alignment padding (%d).", pad));
+	if (pad) {
+		f->seek(f->get_position() + pad);
+	}
+	return OK;
+}
+
 static Error read_reals(real_t *dst, Ref<FileAccess> &f, size_t count) {
 	if (f->real_is_double) {
 		if constexpr (sizeof(real_t) == 8) {
@@ -508,6 +525,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_PACKED_BYTE_ARRAY: {
 			uint32_t len = f->get_32();
+			Error align_err = _advance_alignment();
+			ERR_FAIL_COND_V(align_err != OK, align_err);
 
 			Vector<uint8_t> array;
 			array.resize(len);
@@ -520,6 +539,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_PACKED_INT32_ARRAY: {
 			uint32_t len = f->get_32();
+			Error align_err = _advance_alignment();
+			ERR_FAIL_COND_V(align_err != OK, align_err);
 
 			Vector<int32_t> array;
 			array.resize(len);
@@ -539,6 +560,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_PACKED_INT64_ARRAY: {
 			uint32_t len = f->get_32();
+			Error align_err = _advance_alignment();
+			ERR_FAIL_COND_V(align_err != OK, align_err);
 
 			Vector<int64_t> array;
 			array.resize(len);
@@ -558,6 +581,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_PACKED_FLOAT32_ARRAY: {
 			uint32_t len = f->get_32();
+			Error align_err = _advance_alignment();
+			ERR_FAIL_COND_V(align_err != OK, align_err);
 
 			Vector<float> array;
 			array.resize(len);
@@ -577,6 +602,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_PACKED_FLOAT64_ARRAY: {
 			uint32_t len = f->get_32();
+			Error align_err = _advance_alignment();
+			ERR_FAIL_COND_V(align_err != OK, align_err);
 
 			Vector<double> array;
 			array.resize(len);
@@ -608,6 +635,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_PACKED_VECTOR2_ARRAY: {
 			uint32_t len = f->get_32();
+			Error align_err = _advance_alignment();
+			ERR_FAIL_COND_V(align_err != OK, align_err);
 
 			Vector<Vector2> array;
 			array.resize(len);
@@ -621,6 +650,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_PACKED_VECTOR3_ARRAY: {
 			uint32_t len = f->get_32();
+			Error align_err = _advance_alignment();
+			ERR_FAIL_COND_V(align_err != OK, align_err);
 
 			Vector<Vector3> array;
 			array.resize(len);
@@ -634,6 +665,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 		} break;
 		case VARIANT_PACKED_COLOR_ARRAY: {
 			uint32_t len = f->get_32();
+			Error align_err = _advance_alignment();
+			ERR_FAIL_COND_V(align_err != OK, align_err);
 
 			Vector<Color> array;
 			array.resize(len);
@@ -683,7 +716,8 @@ Error ResourceLoaderBinary::load() {
 		}
 
 		external_resources.write[i].path = path; //remap happens here, not on load because on load it can actually be used for filesystem dock resource remap
-		external_resources.write[i].load_token = ResourceLoader::_load_start(path, external_resources[i].type, use_sub_threads ? ResourceLoader::LOAD_THREAD_DISTRIBUTE : ResourceLoader::LOAD_THREAD_FROM_CURRENT, cache_mode_for_external);
+		ResourceLoader::LoadThreadMode thread_mode = ResourceLoader::_get_dependency_thread_mode(path, external_resources[i].type, use_sub_threads, i == external_resources.size() - 1);
+		external_resources.write[i].load_token = ResourceLoader::_load_start(path, external_resources[i].type, thread_mode, cache_mode_for_external);
 		if (!external_resources[i].load_token.is_valid()) {
 			if (!ResourceLoader::get_abort_on_missing_resources()) {
 				ResourceLoader::notify_dependency_error(local_path, path, external_resources[i].type);
@@ -1547,6 +1581,28 @@ void ResourceFormatSaverBinaryInstance::_pad_buffer(Ref<FileAccess> f, int p_byt
 	}
 }
 
+void ResourceFormatSaverBinaryInstance::_pad_alignment(Ref<FileAccess> f) {
+	uint32_t pad = (PACKED_ARRAY_ALIGNMENT - (f->get_position() + 4) % PACKED_ARRAY_ALIGNMENT) % PACKED_ARRAY_ALIGNMENT;
+	f->store_32(pad);
+	for (uint32_t i = 0; i < pad; i++) {
+		f->store_8(0);
+	}
+}
+
+// Stores the array as is when its in-memory layout matches the file layout.
+template <typename T>
+static bool _store_packed_array_raw(Ref<FileAccess> &f, const T *p_data, int p_count) {
+#ifdef BIG_ENDIAN_ENABLED
+	return false;
+#else
+	if (f->is_big_endian()) {
+		return false;
+	}
+	f->store_buffer((const uint8_t *)p_data, p_count * sizeof(T));
+	return true;
+#endif
+}
+
 void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const Variant &p_property, HashMap<Ref<Resource>, int> &resource_map, HashMap<Ref<Resource>, int> &external_resources, HashMap<StringName, int> &string_map, const PropertyInfo &p_hint) {
 	switch (p_property.get_type()) {
 		case Variant::NIL: {
@@ -1854,6 +1910,7 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 			Vector<uint8_t> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_pad_alignment(f);
 			const uint8_t *r = arr.ptr();
 			f->store_buffer(r, len);
 			_pad_buffer(f, len);
@@ -1864,9 +1921,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 			Vector<int32_t> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_pad_alignment(f);
 			const int32_t *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_32(r[i]);
+			if (!_store_packed_array_raw(f, r, len)) {
+				for (int i = 0; i < len; i++) {
+					f->store_32(r[i]);
+				}
 			}
 
 		} break;
@@ -1875,9 +1935,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 			Vector<int64_t> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_pad_alignment(f);
 			const int64_t *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_64(r[i]);
+			if (!_store_packed_array_raw(f, r, len)) {
+				for (int i = 0; i < len; i++) {
+					f->store_64(r[i]);
+				}
 			}
 
 		} break;
@@ -1886,9 +1949,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 			Vector<float> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_pad_alignment(f);
 			const float *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_float(r[i]);
+			if (!_store_packed_array_raw(f, r, len)) {
+				for (int i = 0; i < len; i++) {
+					f->store_float(r[i]);
+				}
 			}
 
 		} break;
@@ -1897,9 +1963,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 			Vector<double> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_pad_alignment(f);
 			const double *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_double(r[i]);
+			if (!_store_packed_array_raw(f, r, len)) {
+				for (int i = 0; i < len; i++) {
+					f->store_double(r[i]);
+				}
 			}
 
 		} break;
@@ -1919,11 +1988,14 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 			Vector<Vector3> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_pad_alignment(f);
 			const Vector3 *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_real(r[i].x);
-				f->store_real(r[i].y);
-				f->store_real(r[i].z);
+			if (!_store_packed_array_raw(f, r, len)) {
+				for (int i = 0; i < len; i++) {
+					f->store_real(r[i].x);
+					f->store_real(r[i].y);
+					f->store_real(r[i].z);
+				}
 			}
 
 		} break;
@@ -1932,10 +2004,13 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 			Vector<Vector2> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_pad_alignment(f);
 			const Vector2 *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_real(r[i].x);
-				f->store_real(r[i].y);
+			if (!_store_packed_array_raw(f, r, len)) {
+				for (int i = 0; i < len; i++) {
+					f->store_real(r[i].x);
+					f->store_real(r[i].y);
+				}
 			}
 
 		} break;
@@ -1944,12 +2019,15 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 			Vector<Color> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_pad_alignment(f);
 			const Color *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_float(r[i].r);
-				f->store_float(r[i].g);
-				f->store_float(r[i].b);
-				f->store_float(r[i].a);
+			if (!_store_packed_array_raw(f, r, len)) {
+				for (int i = 0; i < len; i++) {
+					f->store_float(r[i].r);
+					f->store_float(r[i].g);
+					f->store_float(r[i].b);
+					f->store_float(r[i].a);
+				}
 			}
 
 		} break;
@@ -354,6 +354,7 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 				}
 			}
 			load_task.resource->set_path(load_task.local_path, replacing);
+			ResourceCache::_notify_miss();
 		} else {
 			load_task.resource->set_path_cache(load_task.local_path);
 		}
@@ -490,6 +491,7 @@ Ref<ResourceLoader::LoadToken> ResourceLoader::_load_start(const String &p_path,
 			if (p_cache_mode == ResourceFormatLoader::CACHE_MODE_REUSE) {
 				Ref<Resource> existing = ResourceCache::get_ref(local_path);
 				if (existing.is_valid()) {
+					ResourceCache::_notify_hit(local_path);
 					//referencing is fine
 					load_task.resource = existing;
 					load_task.status = THREAD_LOAD_LOADED;
@@ -711,6 +713,31 @@ Ref<Resource> ResourceLoader::_load_complete_inner(LoadToken &p_load_token, Erro
 	}
 }
 
+// Loaders start all their external dependencies before parsing their own data.
+// Unless they were asked to use sub-threads anyway, all but the last one can be
+// handed to the worker pool so they load in parallel. The last one is loaded on
+// the current thread, which would otherwise just sit waiting for the others.
+// Only resources without dependencies of their own are handed out: a pool task
+// loading dependencies may have to wait for one an older sibling task is loading,
+// which the pool refuses (ERR_BUSY), and the load would then be restarted as a
+// second, separate copy of that resource.
+// Parsing each dependency up front to find out would add back the serial cost, so
+// this is decided from the path and type: imported files (textures, audio, fonts...)
+// don't refer to other files, except for imported scenes.
+ResourceLoader::LoadThreadMode ResourceLoader::_get_dependency_thread_mode(const String &p_path, const String &p_type, bool p_use_sub_threads, bool p_is_last) {
+	if (p_use_sub_threads) {
+		return LOAD_THREAD_DISTRIBUTE;
+	}
+	if (!parallel_dependency_loading || p_is_last || ResourceCache::has(p_path)) {
+		return LOAD_THREAD_FROM_CURRENT;
+	}
+	if (p_type.is_empty() || ClassDB::is_parent_class(p_type, "PackedScene")) {
+		return LOAD_THREAD_FROM_CURRENT;
+	}
+
+	return ResourceFormatImporter::get_singleton()->recognize_path(p_path) ? LOAD_THREAD_DISTRIBUTE : LOAD_THREAD_FROM_CURRENT;
+}
+
 bool ResourceLoader::exists(const String &p_path, const String &p_type_hint) {
 	String local_path = _validate_local_path(p_path);
 
@@ -1198,6 +1225,7 @@ DependencyErrorNotify ResourceLoader::dep_err_notify = nullptr;
 bool ResourceLoader::create_missing_resources_if_class_unavailable = false;
 bool ResourceLoader::abort_on_missing_resource = true;
 bool ResourceLoader::timestamp_on_load = false;
+bool ResourceLoader::parallel_dependency_loading = false;
 
 thread_local int ResourceLoader::load_nesting = 0;
 thread_local WorkerThreadPool::TaskID ResourceLoader::caller_task_id = 0;
@@ -132,6 +132,7 @@ public:
 
 	static Ref<LoadToken> _load_start(const String &p_path, const String &p_type_hint, LoadThreadMode p_thread_mode, ResourceFormatLoader::CacheMode p_cache_mode);
 	static Ref<Resource> _load_complete(LoadToken &p_load_token, Error *r_error);
+	static LoadThreadMode _get_dependency_thread_mode(const String &p_path, const String &p_type, bool p_use_sub_threads, bool p_is_last);
 
 private:
 	static Ref<Resource> _load_complete_inner(LoadToken &p_load_token, Error *r_error, MutexLock<SafeBinaryMutex<BINARY_MUTEX_TAG>> &p_thread_load_lock);
@@ -139,6 +140,7 @@ private:
 	static Ref<ResourceFormatLoader> loader[MAX_LOADERS];
 	static int loader_count;
 	static bool timestamp_on_load;
+	static bool parallel_dependency_loading;
 
 	static void *err_notify_ud;
 	static ResourceLoadErrorNotify err_notify;
@@ -223,6 +225,9 @@ public:
 	static void set_timestamp_on_load(bool p_timestamp) { timestamp_on_load = p_timestamp; }
 	static bool get_timestamp_on_load() { return timestamp_on_load; }
 
+	static void set_parallel_dependency_loading(bool p_enable) { parallel_dependency_loading = p_enable; }
+	static bool is_parallel_dependency_loading_enabled() { return parallel_dependency_loading; }
+
 	// Loaders can safely use this regardless which thread they are running on.
 	static void notify_load_error(const String &p_err) {
 		if (err_notify) {
@@ -213,13 +213,14 @@ void StreamPeer::put_utf8_string(const String &p_string) {
 }
 
 void StreamPeer::put_var(const Variant &p_variant, bool p_full_objects) {
-	int len = 0;
+	// Leave room for the length prefix, so everything goes out in a single put_data().
+	int len = 4;
 	Vector<uint8_t> buf;
-	encode_variant(p_variant, nullptr, len, p_full_objects);
 	buf.resize(len);
-	put_32(len);
-	encode_variant(p_variant, buf.ptrw(), len, p_full_objects);
-	put_data(buf.ptr(), buf.size());
+	Error err = encode_variant(p_variant, buf, len, p_full_objects);
+	ERR_FAIL_COND_MSG(err != OK, "Error when trying to encode Variant.");
+	encode_uint32(uint32_t(len - 4), buf.ptrw());
+	put_data(buf.ptr(), len);
 }
 
 uint8_t StreamPeer::get_u8() {
@@ -1144,35 +1144,34 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 		return ERR_UNAVAILABLE;
 	}
 
+	if (s->dispatch_dirty) {
+		_update_signal_dispatch(s);
+	}
+
 	// If this is a ref-counted object, prevent it from being destroyed during signal emission,
 	// which is needed in certain edge cases; e.g., https://github.com/godotengine/godot/issues/73889.
-	Ref<RefCounted> rc = Ref<RefCounted>(Object::cast_to<RefCounted>(this));
+	Ref<RefCounted> rc = Ref<RefCounted>(is_ref_counted() ? static_cast<RefCounted *>(this) : nullptr);
 
 	// Ensure that disconnecting the signal or even deleting the object
-	// will not affect the signal calling.
-	Callable *slot_callables = (Callable *)alloca(sizeof(Callable) * s->slot_map.size());
-	uint32_t *slot_flags = (uint32_t *)alloca(sizeof(uint32_t) * s->slot_map.size());
-	uint32_t slot_count = 0;
-
-	for (const KeyValue<Callable, SignalData::Slot> &slot_kv : s->slot_map) {
-		memnew_placement(&slot_callables[slot_count], Callable(slot_kv.value.conn.callable));
-		slot_flags[slot_count] = slot_kv.value.conn.flags;
-		++slot_count;
-	}
-
-	DEV_ASSERT(slot_count == s->slot_map.size());
+	// will not affect the signal calling. Connection changes rebuild the
+	// dispatch list instead of modifying it, so holding a reference is enough.
+	const Vector<SignalData::Dispatch> dispatch = s->dispatch;
+	const SignalData::Dispatch *slots = dispatch.ptr();
+	const uint32_t slot_count = dispatch.size();
 
 	// Disconnect all one-shot connections before emitting to prevent recursion.
-	for (uint32_t i = 0; i < slot_count; ++i) {
-		bool disconnect = slot_flags[i] & CONNECT_ONE_SHOT;
+	if (s->dispatch_one_shot_count > 0) {
+		for (uint32_t i = 0; i < slot_count; ++i) {
+			bool disconnect = slots[i].flags & CONNECT_ONE_SHOT;
 #ifdef TOOLS_ENABLED
-		if (disconnect && (slot_flags[i] & CONNECT_PERSIST) && Engine::get_singleton()->is_editor_hint()) {
-			// This signal was connected from the editor, and is being edited. Just don't disconnect for now.
-			disconnect = false;
-		}
+			if (disconnect && (slots[i].flags & CONNECT_PERSIST) && Engine::get_singleton()->is_editor_hint()) {
+				// This signal was connected from the editor, and is being edited. Just don't disconnect for now.
+				disconnect = false;
+			}
 #endif
-		if (disconnect) {
-			_disconnect(p_name, slot_callables[i]);
+			if (disconnect) {
+				_disconnect(p_name, slots[i].callable);
+			}
 		}
 	}
 
@@ -1181,8 +1180,8 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 	Error err = OK;
 
 	for (uint32_t i = 0; i < slot_count; ++i) {
-		const Callable &callable = slot_callables[i];
-		const uint32_t &flags = slot_flags[i];
+		const Callable &callable = slots[i].callable;
+		const uint32_t flags = slots[i].flags;
 
 		if (!callable.is_valid()) {
 			// Target might have been deleted during signal callback, this is expected and OK.
@@ -1218,11 +1217,28 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 		}
 	}
 
-	for (uint32_t i = 0; i < slot_count; ++i) {
-		slot_callables[i].~Callable();
+	return err;
+}
+
+void Object::_update_signal_dispatch(SignalData *p_signal_data) {
+	// Build a new list rather than writing to the current one, which may still be in use by an emission.
+	Vector<SignalData::Dispatch> dispatch;
+	dispatch.resize(p_signal_data->slot_map.size());
+	SignalData::Dispatch *w = dispatch.ptrw();
+	uint32_t one_shot_count = 0;
+
+	for (const KeyValue<Callable, SignalData::Slot> &slot_kv : p_signal_data->slot_map) {
+		w->callable = slot_kv.value.conn.callable;
+		w->flags = slot_kv.value.conn.flags;
+		if (w->flags & CONNECT_ONE_SHOT) {
+			one_shot_count++;
+		}
+		w++;
 	}
 
-	return err;
+	p_signal_data->dispatch = dispatch;
+	p_signal_data->dispatch_one_shot_count = one_shot_count;
+	p_signal_data->dispatch_dirty = false;
 }
 
 void Object::_add_user_signal(const String &p_name, const Array &p_args) {
@@ -1432,6 +1448,8 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, ui
 
 	//use callable version as key, so binds can be ignored
 	s->slot_map[*p_callable.get_base_comparator()] = slot;
+	s->dispatch.clear();
+	s->dispatch_dirty = true;
 
 	return OK;
 }
@@ -1489,6 +1507,9 @@ bool Object::_disconnect(const StringName &p_signal, const Callable &p_callable,
 	}
 
 	s->slot_map.erase(*p_callable.get_base_comparator());
+	// Drop the cached copies now, so disconnected callables don't keep their bound arguments alive.
+	s->dispatch.clear();
+	s->dispatch_dirty = true;
 
 	if (s->slot_map.is_empty() && ClassDB::has_signal(get_class_name(), p_signal)) {
 		//not user signal, delete
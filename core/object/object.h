@@ -617,11 +617,23 @@ private:
 			List<Connection>::Element *cE = nullptr;
 		};
 
+		struct Dispatch {
+			Callable callable;
+			uint32_t flags = 0;
+		};
+
 		MethodInfo user;
 		HashMap<Callable, Slot, HashableHasher<Callable>> slot_map;
+
+		// Flat copy of the connections in slot_map order, rebuilt lazily once they change.
+		// Emission holds a reference to it instead of copying every callable.
+		Vector<Dispatch> dispatch;
+		uint32_t dispatch_one_shot_count = 0;
+		bool dispatch_dirty = true;
 	};
 
 	HashMap<StringName, SignalData> signal_map;
+	static void _update_signal_dispatch(SignalData *p_signal_data);
 	List<Connection> connections;
 #ifdef DEBUG_ENABLED
 	SafeRefCount _lock_index;
@@ -42,6 +42,9 @@ class RefCounted : public Object {
 protected:
 	static void _bind_methods();
 
+	// Takes the last reference back, for an object that canceled its deletion from NOTIFICATION_PREDELETE.
+	void _revive_reference() { refcount.init(); }
+
 public:
 	_FORCE_INLINE_ bool is_referenced() const { return refcount_init.get() != 1; }
 	bool init_ref();
@@ -43,6 +43,7 @@
 #include "core/input/input.h"
 #include "core/input/input_map.h"
 #include "core/input/shortcut.h"
+#include "core/io/async_file_reader.h"
 #include "core/io/config_file.h"
 #include "core/io/dir_access.h"
 #include "core/io/dtls_server.h"
@@ -108,6 +109,7 @@ static core_bind::Geometry2D *_geometry_2d = nullptr;
 static core_bind::Geometry3D *_geometry_3d = nullptr;
 
 static WorkerThreadPool *worker_thread_pool = nullptr;
+static AsyncFileReader *async_file_reader = nullptr;
 
 extern Mutex _global_mutex;
 
@@ -298,6 +300,7 @@ void register_core_types() {
 	GDREGISTER_NATIVE_STRUCT(ScriptLanguageExtensionProfilingInfo, "StringName signature;uint64_t call_count;uint64_t total_time;uint64_t self_time");
 
 	worker_thread_pool = memnew(WorkerThreadPool);
+	async_file_reader = memnew(AsyncFileReader);
 
 	OS::get_singleton()->benchmark_end_measure("Core", "Register Types");
 }
@@ -310,6 +313,9 @@ void register_core_settings() {
 
 	GLOBAL_DEF("threading/worker_pool/max_threads", -1);
 	GLOBAL_DEF("threading/worker_pool/low_priority_thread_ratio", 0.3);
+	GLOBAL_DEF("threading/resource_loader/parallel_dependency_loading", false);
+
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "memory/limits/resource_cache/retained_size_mb", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"), 0);
 }
 
 void register_core_singletons() {
@@ -382,6 +388,7 @@ void unregister_core_types() {
 
 	// Destroy singletons in reverse order to ensure dependencies are not broken.
 
+	memdelete(async_file_reader);
 	memdelete(worker_thread_pool);
 
 	memdelete(_engine_debugger);
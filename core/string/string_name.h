@@ -48,7 +48,17 @@ class StringName {
 	enum {
 		STRING_TABLE_BITS = 16,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+		// The table is split in shards, each guarded by its own lock, so that
+		// threads interning unrelated names don't contend on a single mutex.
+		STRING_TABLE_LOCK_BITS = 6,
+		STRING_TABLE_LOCK_COUNT = 1 << STRING_TABLE_LOCK_BITS,
+		STRING_TABLE_LOCK_MASK = STRING_TABLE_LOCK_COUNT - 1
+	};
+
+	// Padded to avoid false sharing between neighboring shards.
+	struct alignas(64) TableLock {
+		Mutex mutex;
 	};
 
 	struct _Data {
@@ -68,6 +78,11 @@ class StringName {
 	};
 
 	static _Data *_table[STRING_TABLE_LEN];
+	static TableLock _table_locks[STRING_TABLE_LOCK_COUNT];
+
+	_FORCE_INLINE_ static Mutex &_get_table_lock(uint32_t p_idx) {
+		return _table_locks[p_idx & STRING_TABLE_LOCK_MASK].mutex;
+	}
 
 	_Data *_data = nullptr;
 
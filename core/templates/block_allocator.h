@@ -0,0 +1,115 @@
+/**************************************************************************/
+/*  block_allocator.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef BLOCK_ALLOCATOR_H
+#define BLOCK_ALLOCATOR_H
+
+#include "core/os/memory.h"
+#include "core/typedefs.h"
+
+// Allocator for elements owned by a single container, e.g. the nodes of one
+// HashMap. Elements are carved out of blocks of doubling size (starting at
+// FIRST_BLOCK_SIZE) instead of being allocated one by one, so a container of N
+// elements needs about log2(N) allocations and wastes less than N slots.
+// Elements never move, freed ones are recycled, and all blocks are released
+// once every element has been freed (e.g. when the container is cleared).
+// Not thread safe, and not copyable: each container owns its own.
+template <typename T, uint32_t FIRST_BLOCK_SIZE = 2, uint32_t MAX_BLOCK_SIZE = 4096>
+class BlockTypedAllocator {
+	static_assert(sizeof(T) >= sizeof(T *), "Elements must be able to hold a free list pointer.");
+
+	T **blocks = nullptr;
+	uint32_t block_count = 0;
+	uint32_t last_block_used = 0;
+	uint32_t last_block_size = 0;
+	uint32_t allocs_used = 0;
+	T *free_list = nullptr;
+
+	void _reset() {
+		for (uint32_t i = 0; i < block_count; i++) {
+			memfree(blocks[i]);
+		}
+		if (blocks) {
+			memfree(blocks);
+		}
+		blocks = nullptr;
+		block_count = 0;
+		last_block_used = 0;
+		last_block_size = 0;
+		free_list = nullptr;
+	}
+
+public:
+	template <typename... Args>
+	T *new_allocation(const Args &&...p_args) {
+		T *alloc;
+		if (free_list) {
+			alloc = free_list;
+			free_list = *reinterpret_cast<T **>(free_list);
+		} else {
+			if (unlikely(last_block_used == last_block_size)) {
+				last_block_size = block_count == 0 ? FIRST_BLOCK_SIZE : MIN(last_block_size * 2, MAX_BLOCK_SIZE);
+				blocks = (T **)memrealloc(blocks, sizeof(T *) * (block_count + 1));
+				blocks[block_count] = (T *)memalloc(sizeof(T) * last_block_size);
+				block_count++;
+				last_block_used = 0;
+			}
+			alloc = &blocks[block_count - 1][last_block_used++];
+		}
+		allocs_used++;
+		memnew_placement(alloc, T(p_args...));
+		return alloc;
+	}
+
+	void delete_allocation(T *p_mem) {
+		p_mem->~T();
+		allocs_used--;
+		if (allocs_used == 0) {
+			_reset();
+			return;
+		}
+		*reinterpret_cast<T **>(p_mem) = free_list;
+		free_list = p_mem;
+	}
+
+	_FORCE_INLINE_ uint32_t get_allocs_used() const { return allocs_used; }
+	_FORCE_INLINE_ uint32_t get_block_count() const { return block_count; }
+
+	BlockTypedAllocator() {}
+	BlockTypedAllocator(const BlockTypedAllocator &) = delete;
+	void operator=(const BlockTypedAllocator &) = delete;
+
+	~BlockTypedAllocator() {
+		ERR_FAIL_COND_MSG(allocs_used > 0, "BlockTypedAllocator destroyed with elements still allocated.");
+		_reset();
+	}
+};
+
+#endif // BLOCK_ALLOCATOR_H
@@ -80,6 +80,30 @@ public:
 		_list.clear();
 	}
 
+	bool erase(const TKey &p_key) {
+		Element *e = _map.getptr(p_key);
+		if (!e) {
+			return false;
+		}
+		_list.erase(*e);
+		_map.erase(p_key);
+		return true;
+	}
+
+	// Removes the least recently used entry, for eviction policies other than the capacity.
+	bool pop_least_recent(TData *r_data = nullptr) {
+		Element d = _list.back();
+		if (!d) {
+			return false;
+		}
+		if (r_data) {
+			*r_data = d->get().data;
+		}
+		_map.erase(d->get().key);
+		_list.pop_back();
+		return true;
+	}
+
 	bool has(const TKey &p_key) const {
 		return _map.getptr(p_key);
 	}
@@ -62,6 +62,19 @@ bool VariantParser::Stream::is_eof() const {
 	return _is_eof();
 }
 
+void VariantParser::Stream::_take_readahead(LocalVector<char32_t> &r_chars) {
+	if (saved) {
+		r_chars.push_back(saved);
+		saved = 0;
+	}
+	while (readahead_pointer < readahead_filled) {
+		r_chars.push_back(readahead_buffer[readahead_pointer++]);
+	}
+	readahead_pointer = 0;
+	readahead_filled = 0;
+	eof = false;
+}
+
 bool VariantParser::StreamFile::is_utf8() const {
 	return true;
 }
@@ -87,6 +100,24 @@ uint32_t VariantParser::StreamFile::_read_buffer(char32_t *p_buffer, uint32_t p_
 	return num_read;
 }
 
+Vector<uint8_t> VariantParser::StreamFile::take_remaining() {
+	LocalVector<char32_t> buffered;
+	_take_readahead(buffered);
+
+	uint64_t rest = f->get_length() - f->get_position();
+	Vector<uint8_t> data;
+	data.resize(buffered.size() + rest);
+	uint8_t *w = data.ptrw();
+	for (uint32_t i = 0; i < buffered.size(); i++) {
+		w[i] = buffered[i]; // Read from the file byte by byte, see _read_buffer().
+	}
+	uint64_t num_read = f->get_buffer(w + buffered.size(), rest);
+	if (num_read != rest) {
+		data.resize(buffered.size() + (num_read == UINT64_MAX ? 0 : num_read));
+	}
+	return data;
+}
+
 bool VariantParser::StreamString::is_utf8() const {
 	return false;
 }
@@ -272,7 +303,7 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 				[[fallthrough]];
 			}
 			case '"': {
-				String str;
+				StringBuffer<> str;
 				char32_t prev = 0;
 				while (true) {
 					char32_t ch = p_stream->get_char();
@@ -394,15 +425,16 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 					return ERR_PARSE_ERROR;
 				}
 
+				String result = str.as_string();
 				if (p_stream->is_utf8()) {
-					str.parse_utf8(str.ascii(true).get_data());
+					result.parse_utf8(result.ascii(true).get_data());
 				}
 				if (string_name) {
 					r_token.type = TK_STRING_NAME;
-					r_token.value = StringName(str);
+					r_token.value = StringName(result);
 				} else {
 					r_token.type = TK_STRING;
-					r_token.value = str;
+					r_token.value = result;
 				}
 				return OK;
 
@@ -546,6 +578,81 @@ Error VariantParser::_parse_enginecfg(Stream *p_stream, Vector<String> &strings,
 	}
 }
 
+// Constructor and packed array arguments are by far the most common tokens in large files,
+// so plain numbers are scanned straight off the stream instead of going through get_token().
+enum ConstructNumber {
+	CONSTRUCT_NUMBER_OK,
+	CONSTRUCT_NUMBER_OTHER, // The stream is left at the next token, which isn't a number.
+	CONSTRUCT_NUMBER_EOF,
+};
+
+template <typename T>
+static ConstructNumber _parse_construct_number(VariantParser::Stream *p_stream, int &line, T &r_value) {
+	char32_t c;
+	while (true) {
+		if (p_stream->saved) {
+			c = p_stream->saved;
+			p_stream->saved = 0;
+		} else {
+			c = p_stream->get_char();
+			if (p_stream->is_eof()) {
+				return CONSTRUCT_NUMBER_EOF;
+			}
+		}
+		if (c == 0) {
+			return CONSTRUCT_NUMBER_EOF;
+		} else if (c == '\n') {
+			line++;
+		} else if (c > 32) {
+			break;
+		}
+	}
+
+	if (c != '-' && !is_digit(c)) {
+		p_stream->saved = c;
+		return CONSTRUCT_NUMBER_OTHER;
+	}
+
+	// Same grammar as in get_token().
+	StringBuffer<> num;
+	if (c == '-') {
+		num += '-';
+		c = p_stream->get_char();
+	}
+
+	int reading = READING_INT;
+	bool exp_sign = false;
+	bool exp_beg = false;
+	bool is_float = false;
+
+	while (true) {
+		if (is_digit(c)) {
+			exp_beg = exp_beg || reading == READING_EXP;
+		} else if (c == '.' && reading == READING_INT) {
+			reading = READING_DEC;
+			is_float = true;
+		} else if (c == 'e' && reading != READING_EXP) {
+			reading = READING_EXP;
+			is_float = true;
+		} else if ((c == '-' || c == '+') && reading == READING_EXP && !exp_sign && !exp_beg) {
+			exp_sign = true;
+		} else {
+			break;
+		}
+		num += c;
+		c = p_stream->get_char();
+	}
+
+	p_stream->saved = c;
+
+	if (is_float) {
+		r_value = (T)num.as_double();
+	} else {
+		r_value = (T)num.as_int();
+	}
+	return CONSTRUCT_NUMBER_OK;
+}
+
 template <typename T>
 Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct, int &line, String &r_err_str) {
 	Token token;
@@ -568,6 +675,18 @@ Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct,
 				return ERR_PARSE_ERROR;
 			}
 		}
+
+		T number;
+		ConstructNumber result = _parse_construct_number(p_stream, line, number);
+		if (result == CONSTRUCT_NUMBER_OK) {
+			r_construct.push_back(number);
+			first = false;
+			continue;
+		} else if (result == CONSTRUCT_NUMBER_EOF) {
+			r_err_str = "Expected float in constructor";
+			return ERR_PARSE_ERROR;
+		}
+
 		get_token(p_stream, token, line, r_err_str);
 
 		if (first && token.type == TK_PARENTHESIS_CLOSE) {
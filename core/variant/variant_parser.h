@@ -33,6 +33,7 @@
 
 #include "core/io/file_access.h"
 #include "core/io/resource.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/variant.h"
 
 class VariantParser {
@@ -50,6 +51,9 @@ public:
 		virtual uint32_t _read_buffer(char32_t *p_buffer, uint32_t p_num_chars) = 0;
 		virtual bool _is_eof() const = 0;
 
+		// Moves the characters read ahead but not consumed yet (saved one first) to r_chars.
+		void _take_readahead(LocalVector<char32_t> &r_chars);
+
 	public:
 		char32_t saved = 0;
 
@@ -71,6 +75,9 @@ public:
 
 		virtual bool is_utf8() const override;
 
+		// Returns the bytes not consumed yet, up to the end of the file, leaving the stream at EOF.
+		Vector<uint8_t> take_remaining();
+
 		StreamFile(bool p_readahead_enabled = true) { readahead_enabled = p_readahead_enabled; }
 	};
 
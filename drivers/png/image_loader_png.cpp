@@ -38,6 +38,11 @@
 
 Error ImageLoaderPNG::load_image(Ref<Image> p_image, Ref<FileAccess> f, BitField<ImageFormatLoader::LoaderFlags> p_flags, float p_scale) {
 	const uint64_t buffer_size = f->get_length();
+	const uint8_t *mapped = f->get_position() == 0 ? f->get_mapped_data() : nullptr;
+	if (mapped) {
+		return PNGDriverCommon::png_to_image(mapped, buffer_size, p_flags & FLAG_FORCE_LINEAR, p_image);
+	}
+
 	Vector<uint8_t> file_buffer;
 	Error err = file_buffer.resize(buffer_size);
 	if (err) {
@@ -37,6 +37,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -142,6 +143,12 @@ void FileAccessUnix::_close() {
 		return;
 	}
 
+	if (mapped) {
+		munmap(mapped, mapped_length);
+		mapped = nullptr;
+		mapped_length = 0;
+	}
+
 	fclose(f);
 	f = nullptr;
 
@@ -282,6 +289,36 @@ uint64_t FileAccessUnix::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	return read;
 }
 
+bool FileAccessUnix::map_data() {
+	ERR_FAIL_NULL_V_MSG(f, false, "File must be opened before use.");
+
+	if (mapped) {
+		return true;
+	}
+	if (flags != READ) {
+		return false;
+	}
+
+	uint64_t length = get_length();
+	if (length == 0 || (uint64_t)(size_t)length != length) {
+		// Empty, or too large for the address space (32-bit builds).
+		return false;
+	}
+
+	void *data = mmap(nullptr, (size_t)length, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+	if (data == MAP_FAILED) {
+		return false;
+	}
+
+	mapped = (uint8_t *)data;
+	mapped_length = length;
+	return true;
+}
+
+const uint8_t *FileAccessUnix::get_mapped_data() const {
+	return mapped;
+}
+
 Error FileAccessUnix::get_error() const {
 	return last_error;
 }
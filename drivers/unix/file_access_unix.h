@@ -43,6 +43,8 @@ typedef void (*CloseNotificationFunc)(const String &p_file, int p_flags);
 class FileAccessUnix : public FileAccess {
 	FILE *f = nullptr;
 	int flags = 0;
+	uint8_t *mapped = nullptr;
+	uint64_t mapped_length = 0;
 	void check_errors() const;
 	mutable Error last_error = OK;
 	String save_path;
@@ -72,6 +74,8 @@ public:
 	virtual uint32_t get_32() const override;
 	virtual uint64_t get_64() const override;
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const override;
+	virtual bool map_data() override;
+	virtual const uint8_t *get_mapped_data() const override;
 
 	virtual Error get_error() const override; ///< get last error
 
@@ -118,6 +118,7 @@
 
 #ifdef MODULE_GDSCRIPT_ENABLED
 #include "modules/gdscript/gdscript.h"
+#include "modules/gdscript/gdscript_sampling_profiler.h"
 #if defined(TOOLS_ENABLED) && !defined(GDSCRIPT_NO_LSP)
 #include "modules/gdscript/language_server/gdscript_language_server.h"
 #endif // TOOLS_ENABLED && !GDSCRIPT_NO_LSP
@@ -219,6 +220,9 @@ static bool debug_paths = false;
 static bool debug_navigation = false;
 static bool debug_avoidance = false;
 static bool debug_canvas_item_redraw = false;
+#ifdef MODULE_GDSCRIPT_ENABLED
+static String gdscript_profile_path;
+#endif
 #endif
 static int max_fps = -1;
 static int frame_delay = 0;
@@ -602,6 +606,9 @@ void Main::print_help(const char *p_binary) {
 	print_help_option("--debug-avoidance", "Show navigation avoidance debug visuals when running the scene.\n", CLI_OPTION_AVAILABILITY_TEMPLATE_DEBUG);
 	print_help_option("--debug-stringnames", "Print all StringName allocations to stdout when the engine quits.\n", CLI_OPTION_AVAILABILITY_TEMPLATE_DEBUG);
 	print_help_option("--debug-canvas-item-redraw", "Display a rectangle each time a canvas item requests a redraw (useful to troubleshoot low processor mode).\n", CLI_OPTION_AVAILABILITY_TEMPLATE_DEBUG);
+#ifdef MODULE_GDSCRIPT_ENABLED
+	print_help_option("--gdscript-profile <file>", "Sample GDScript call stacks while running and save them to <file> on exit, in collapsed stack format (for flame graph tools).\n", CLI_OPTION_AVAILABILITY_TEMPLATE_DEBUG);
+#endif
 
 #endif
 	print_help_option("--max-fps <fps>", "Set a maximum number of frames per second rendered (can be used to limit power usage). A value of 0 results in unlimited framerate.\n");
@@ -1595,6 +1602,16 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 			debug_canvas_item_redraw = true;
 		} else if (I->get() == "--debug-stringnames") {
 			StringName::set_debug_stringnames(true);
+#ifdef MODULE_GDSCRIPT_ENABLED
+		} else if (I->get() == "--gdscript-profile") {
+			if (I->next()) {
+				gdscript_profile_path = I->next()->get();
+				N = I->next()->next();
+			} else {
+				OS::get_singleton()->print("Missing file path argument for --gdscript-profile, aborting.\n");
+				goto error;
+			}
+#endif
 #endif
 		} else if (I->get() == "--remote-debug") {
 			if (I->next()) {
@@ -1756,12 +1773,17 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 			int worker_threads = GLOBAL_GET("threading/worker_pool/max_threads");
 			float low_priority_ratio = GLOBAL_GET("threading/worker_pool/low_priority_thread_ratio");
 			WorkerThreadPool::get_singleton()->init(worker_threads, low_priority_ratio);
+			ResourceLoader::set_parallel_dependency_loading(GLOBAL_GET("threading/resource_loader/parallel_dependency_loading"));
 		}
 #else
 		WorkerThreadPool::get_singleton()->init(0, 0);
 #endif
 	}
 
+	if (!editor && !project_manager) {
+		ResourceCache::set_retained_budget(uint64_t(GLOBAL_GET("memory/limits/resource_cache/retained_size_mb")) * 1024 * 1024);
+	}
+
 #ifdef TOOLS_ENABLED
 	if (editor) {
 		Engine::get_singleton()->set_editor_hint(true);
@@ -3097,6 +3119,12 @@ Error Main::setup2() {
 	// This loads global classes, so it must happen before custom loaders and savers are registered
 	ScriptServer::init_languages();
 
+#if defined(DEBUG_ENABLED) && defined(MODULE_GDSCRIPT_ENABLED)
+	if (!gdscript_profile_path.is_empty()) {
+		GDScriptSamplingProfiler::start();
+	}
+#endif
+
 	theme_db->initialize_theme();
 	audio_server->load_default_bus_layout();
 
@@ -4137,6 +4165,7 @@ void Main::cleanup(bool p_force) {
 	}
 
 	ResourceLoader::clear_thread_load_tasks();
+	ResourceCache::clear_retained();
 
 	ResourceLoader::remove_custom_loaders();
 	ResourceSaver::remove_custom_savers();
@@ -4154,6 +4183,15 @@ void Main::cleanup(bool p_force) {
 	ResourceLoader::clear_translation_remaps();
 	ResourceLoader::clear_path_remaps();
 
+#if defined(DEBUG_ENABLED) && defined(MODULE_GDSCRIPT_ENABLED)
+	if (!gdscript_profile_path.is_empty()) {
+		GDScriptSamplingProfiler::stop();
+		GDScriptSamplingProfiler::save_folded(gdscript_profile_path);
+		GDScriptSamplingProfiler::print_hot_lines();
+		GDScriptSamplingProfiler::clear();
+	}
+#endif
+
 	ScriptServer::finish_languages();
 
 	// Sync pending commands that may have been queued from a different thread during ScriptServer finalization
@@ -30,6 +30,8 @@
 
 #include "performance.h"
 
+#include "core/io/resource.h"
+#include "core/object/message_queue.h"
 #include "core/os/os.h"
 #include "core/variant/typed_array.h"
 #include "scene/main/node.h"
@@ -89,6 +91,10 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_MERGE_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_FREE_COUNT);
+	BIND_ENUM_CONSTANT(RESOURCE_CACHE_HITS);
+	BIND_ENUM_CONSTANT(RESOURCE_CACHE_MISSES);
+	BIND_ENUM_CONSTANT(RESOURCE_CACHE_EVICTIONS);
+	BIND_ENUM_CONSTANT(RESOURCE_CACHE_RETAINED_SIZE);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -139,6 +145,10 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"navigation/edges_merged",
 		"navigation/edges_connected",
 		"navigation/edges_free",
+		"resource_cache/hits",
+		"resource_cache/misses",
+		"resource_cache/evictions",
+		"resource_cache/retained_size",
 
 	};
 
@@ -223,6 +233,14 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT);
 		case NAVIGATION_EDGE_FREE_COUNT:
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
+		case RESOURCE_CACHE_HITS:
+			return ResourceCache::get_hit_count();
+		case RESOURCE_CACHE_MISSES:
+			return ResourceCache::get_miss_count();
+		case RESOURCE_CACHE_EVICTIONS:
+			return ResourceCache::get_eviction_count();
+		case RESOURCE_CACHE_RETAINED_SIZE:
+			return ResourceCache::get_retained_size();
 
 		default: {
 		}
@@ -270,6 +288,10 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
 
 	};
 
@@ -337,6 +359,31 @@ Performance::Performance() {
 	_navigation_process_time = 0;
 	_monitor_modification_time = 0;
 	singleton = this;
+	ResourceCache::retained_type_added_func = _resource_cache_type_added;
+}
+
+Performance::~Performance() {
+	ResourceCache::retained_type_added_func = nullptr;
+	singleton = nullptr;
+}
+
+// Called when a resource type is retained in the cache for the first time, from whichever thread released it.
+// Loading threads have their own message queue override, which is discarded when loading ends, so post to the main one.
+void Performance::_resource_cache_type_added(const StringName &p_type) {
+	CallQueue *main_queue = MessageQueue::get_main_singleton();
+	if (main_queue) {
+		main_queue->push_callable(callable_mp(singleton, &Performance::_add_resource_cache_type_monitor), p_type);
+	}
+}
+
+void Performance::_add_resource_cache_type_monitor(const StringName &p_type) {
+	const StringName id = "ResourceCache/" + String(p_type);
+	if (has_custom_monitor(id)) {
+		return;
+	}
+	Vector<Variant> args;
+	args.push_back(p_type);
+	add_custom_monitor(id, callable_mp_static(&ResourceCache::get_retained_size_for_type), args);
 }
 
 Performance::MonitorCall::MonitorCall(Callable p_callable, Vector<Variant> p_arguments) {
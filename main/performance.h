@@ -48,6 +48,9 @@ class Performance : public Object {
 
 	int _get_node_count() const;
 
+	static void _resource_cache_type_added(const StringName &p_type);
+	void _add_resource_cache_type_monitor(const StringName &p_type);
+
 	double _process_time;
 	double _physics_process_time;
 	double _navigation_process_time;
@@ -100,6 +103,10 @@ public:
 		NAVIGATION_EDGE_MERGE_COUNT,
 		NAVIGATION_EDGE_CONNECTION_COUNT,
 		NAVIGATION_EDGE_FREE_COUNT,
+		RESOURCE_CACHE_HITS,
+		RESOURCE_CACHE_MISSES,
+		RESOURCE_CACHE_EVICTIONS,
+		RESOURCE_CACHE_RETAINED_SIZE,
 		MONITOR_MAX
 	};
 
@@ -129,6 +136,7 @@ public:
 	static Performance *get_singleton() { return singleton; }
 
 	Performance();
+	~Performance();
 };
 
 VARIANT_ENUM_CAST(Performance::Monitor);
@@ -2181,6 +2181,7 @@ String GDScriptLanguage::get_extension() const {
 
 void GDScriptLanguage::finish() {
 	_call_stack.free();
+	GDScriptFunctionState::finish_stack_pool();
 
 	// Clear the cache before parsing the script_list
 	GDScriptCache::clear();
@@ -31,6 +31,9 @@
 #include "gdscript_function.h"
 
 #include "gdscript.h"
+#include "gdscript_sampling_profiler.h"
+
+#include "core/os/spin_lock.h"
 
 Variant GDScriptFunction::get_constant(int p_idx) const {
 	ERR_FAIL_INDEX_V(p_idx, constants.size(), "<errconst>");
@@ -115,6 +118,10 @@ GDScriptFunction::GDScriptFunction() {
 }
 
 GDScriptFunction::~GDScriptFunction() {
+#ifdef DEBUG_ENABLED
+	GDScriptSamplingProfiler::function_freed(this);
+#endif
+
 	get_script()->member_functions.erase(name);
 
 	for (int i = 0; i < lambdas.size(); i++) {
@@ -246,12 +253,15 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 #endif
 	}
 
+	// The call destroyed the stack contents, only the buffer is left to recycle.
+	_release_stack();
+
 	return ret;
 }
 
 void GDScriptFunctionState::_clear_stack() {
 	if (state.stack_size) {
-		Variant *stack = (Variant *)state.stack.ptr();
+		Variant *stack = (Variant *)state.stack;
 		// The first 3 are special addresses and not copied to the state, so we skip them here.
 		for (int i = 3; i < state.stack_size; i++) {
 			stack[i].~Variant();
@@ -260,6 +270,88 @@ void GDScriptFunctionState::_clear_stack() {
 	}
 }
 
+// Stack buffers of suspended calls are pooled by power-of-two size class, so that
+// awaiting in a loop reuses the same few buffers instead of hitting the allocator.
+// Larger stacks are rare and bypass the pool.
+
+#define STACK_POOL_MIN_SHIFT 6 // 64 bytes, also room for the free list link.
+#define STACK_POOL_CLASSES 11 // Up to 64 KiB.
+#define STACK_POOL_MAX_FREE 128 // Per size class.
+
+static struct {
+	SpinLock lock;
+	uint8_t *free_list[STACK_POOL_CLASSES] = {};
+	uint32_t free_count[STACK_POOL_CLASSES] = {};
+	bool enabled = true;
+} stack_pool;
+
+static _FORCE_INLINE_ int _get_stack_size_class(uint32_t p_size) {
+	int size_class = 0;
+	while ((1u << (size_class + STACK_POOL_MIN_SHIFT)) < p_size) {
+		size_class++;
+	}
+	return size_class;
+}
+
+uint8_t *GDScriptFunctionState::_stack_alloc(uint32_t p_size) {
+	int size_class = _get_stack_size_class(p_size);
+	if (size_class >= STACK_POOL_CLASSES) {
+		return (uint8_t *)memalloc(p_size);
+	}
+
+	stack_pool.lock.lock();
+	uint8_t *stack = stack_pool.free_list[size_class];
+	if (stack) {
+		stack_pool.free_list[size_class] = *(uint8_t **)stack;
+		stack_pool.free_count[size_class]--;
+	}
+	stack_pool.lock.unlock();
+	if (stack) {
+		return stack;
+	}
+
+	return (uint8_t *)memalloc(1u << (size_class + STACK_POOL_MIN_SHIFT));
+}
+
+void GDScriptFunctionState::_stack_free(uint8_t *p_stack, uint32_t p_size) {
+	int size_class = _get_stack_size_class(p_size);
+	if (size_class < STACK_POOL_CLASSES) {
+		stack_pool.lock.lock();
+		if (stack_pool.enabled && stack_pool.free_count[size_class] < STACK_POOL_MAX_FREE) {
+			*(uint8_t **)p_stack = stack_pool.free_list[size_class];
+			stack_pool.free_list[size_class] = p_stack;
+			stack_pool.free_count[size_class]++;
+			stack_pool.lock.unlock();
+			return;
+		}
+		stack_pool.lock.unlock();
+	}
+
+	memfree(p_stack);
+}
+
+void GDScriptFunctionState::_release_stack() {
+	if (state.stack) {
+		_stack_free(state.stack, state.alloca_size);
+		state.stack = nullptr;
+		state.stack_size = 0;
+	}
+}
+
+void GDScriptFunctionState::finish_stack_pool() {
+	stack_pool.lock.lock();
+	stack_pool.enabled = false;
+	for (int i = 0; i < STACK_POOL_CLASSES; i++) {
+		while (stack_pool.free_list[i]) {
+			uint8_t *stack = stack_pool.free_list[i];
+			stack_pool.free_list[i] = *(uint8_t **)stack;
+			memfree(stack);
+		}
+		stack_pool.free_count[i] = 0;
+	}
+	stack_pool.lock.unlock();
+}
+
 void GDScriptFunctionState::_clear_connections() {
 	List<Object::Connection> conns;
 	get_signals_connected_to_this(&conns);
@@ -288,4 +380,61 @@ GDScriptFunctionState::~GDScriptFunctionState() {
 		scripts_list.remove_from_list();
 		instances_list.remove_from_list();
 	}
+	_release_stack();
+}
+
+/////////////////////
+
+bool GDScriptFunctionStateCallable::compare_equal(const CallableCustom *p_a, const CallableCustom *p_b) {
+	// Only one of these exists per state, compare by reference.
+	return p_a == p_b;
+}
+
+bool GDScriptFunctionStateCallable::compare_less(const CallableCustom *p_a, const CallableCustom *p_b) {
+	return p_a < p_b;
+}
+
+uint32_t GDScriptFunctionStateCallable::hash() const {
+	return hash_murmur3_one_64((uint64_t)state->get_instance_id());
+}
+
+String GDScriptFunctionStateCallable::get_as_text() const {
+	return "GDScriptFunctionState::_signal_callback";
+}
+
+CallableCustom::CompareEqualFunc GDScriptFunctionStateCallable::get_compare_equal_func() const {
+	return compare_equal;
+}
+
+CallableCustom::CompareLessFunc GDScriptFunctionStateCallable::get_compare_less_func() const {
+	return compare_less;
+}
+
+ObjectID GDScriptFunctionStateCallable::get_object() const {
+	return state->get_instance_id();
+}
+
+StringName GDScriptFunctionStateCallable::get_method() const {
+	return SNAME("_signal_callback");
+}
+
+void GDScriptFunctionStateCallable::call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const {
+	// Same argument packing as `GDScriptFunctionState::_signal_callback()`, minus the bound state.
+	r_call_error.error = Callable::CallError::CALL_OK;
+
+	if (p_argcount == 0) {
+		r_return_value = state->resume();
+	} else if (p_argcount == 1) {
+		r_return_value = state->resume(*p_arguments[0]);
+	} else {
+		Array extra_args;
+		for (int i = 0; i < p_argcount; i++) {
+			extra_args.push_back(*p_arguments[i]);
+		}
+		r_return_value = state->resume(extra_args);
+	}
+}
+
+GDScriptFunctionStateCallable::GDScriptFunctionStateCallable(const Ref<GDScriptFunctionState> &p_state) :
+		state(p_state) {
 }
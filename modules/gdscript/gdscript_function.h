@@ -497,7 +497,7 @@ public:
 		StringName function_name;
 		String script_path;
 #endif
-		Vector<uint8_t> stack;
+		uint8_t *stack = nullptr;
 		int stack_size = 0;
 		uint32_t alloca_size = 0;
 		int ip = 0;
@@ -541,6 +541,10 @@ class GDScriptFunctionState : public RefCounted {
 	SelfList<GDScriptFunctionState> scripts_list;
 	SelfList<GDScriptFunctionState> instances_list;
 
+	static uint8_t *_stack_alloc(uint32_t p_size);
+	static void _stack_free(uint8_t *p_stack, uint32_t p_size);
+	void _release_stack();
+
 protected:
 	static void _bind_methods();
 
@@ -551,8 +555,31 @@ public:
 	void _clear_stack();
 	void _clear_connections();
 
+	static void finish_stack_pool();
+
 	GDScriptFunctionState();
 	~GDScriptFunctionState();
 };
 
+// Resumes a GDScriptFunctionState directly when the awaited signal is emitted,
+// avoiding the method lookup and bound argument copy of a regular `Callable`.
+class GDScriptFunctionStateCallable : public CallableCustom {
+	Ref<GDScriptFunctionState> state;
+
+	static bool compare_equal(const CallableCustom *p_a, const CallableCustom *p_b);
+	static bool compare_less(const CallableCustom *p_a, const CallableCustom *p_b);
+
+public:
+	uint32_t hash() const override;
+	String get_as_text() const override;
+	CompareEqualFunc get_compare_equal_func() const override;
+	CompareLessFunc get_compare_less_func() const override;
+	ObjectID get_object() const override;
+	StringName get_method() const override;
+	void call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const override;
+
+	GDScriptFunctionStateCallable(const Ref<GDScriptFunctionState> &p_state);
+	virtual ~GDScriptFunctionStateCallable() = default;
+};
+
 #endif // GDSCRIPT_FUNCTION_H
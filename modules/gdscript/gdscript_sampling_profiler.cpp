@@ -0,0 +1,311 @@
+/**************************************************************************/
+/*  gdscript_sampling_profiler.cpp                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_sampling_profiler.h"
+
+#ifdef DEBUG_ENABLED
+
+#include "gdscript_function.h"
+
+#include "core/io/file_access.h"
+#include "core/object/method_bind.h"
+#include "core/os/os.h"
+#include "core/templates/sort_array.h"
+
+thread_local GDScriptSamplingProfiler::ThreadStack GDScriptSamplingProfiler::thread_stack;
+
+SafeFlag GDScriptSamplingProfiler::active;
+SafeFlag GDScriptSamplingProfiler::exit_thread;
+SafeNumeric<uint64_t> GDScriptSamplingProfiler::tick;
+uint64_t GDScriptSamplingProfiler::interval_usec = 1000;
+Thread GDScriptSamplingProfiler::sampler_thread;
+
+Mutex GDScriptSamplingProfiler::mutex;
+LocalVector<GDScriptSamplingProfiler::FunctionInfo> GDScriptSamplingProfiler::functions;
+HashMap<const void *, uint32_t> GDScriptSamplingProfiler::function_ids;
+HashMap<GDScriptSamplingProfiler::SampleStack, uint64_t, GDScriptSamplingProfiler::SampleStackHasher> GDScriptSamplingProfiler::stack_samples;
+HashMap<GDScriptSamplingProfiler::SampleFrame, uint64_t, GDScriptSamplingProfiler::SampleFrameHasher> GDScriptSamplingProfiler::line_samples;
+uint64_t GDScriptSamplingProfiler::total_samples = 0;
+
+bool GDScriptSamplingProfiler::SampleStack::operator==(const SampleStack &p_other) const {
+	if (frames.size() != p_other.frames.size()) {
+		return false;
+	}
+	for (uint32_t i = 0; i < frames.size(); i++) {
+		if (!(frames[i] == p_other.frames[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+uint32_t GDScriptSamplingProfiler::SampleStackHasher::hash(const SampleStack &p_stack) {
+	uint32_t h = HASH_MURMUR3_SEED;
+	for (const SampleFrame &frame : p_stack.frames) {
+		h = hash_murmur3_one_32(frame.function, h);
+		h = hash_murmur3_one_32(frame.line, h);
+	}
+	return hash_fmix32(h);
+}
+
+void GDScriptSamplingProfiler::_sampler_thread_func(void *p_userdata) {
+	while (!exit_thread.is_set()) {
+		OS::get_singleton()->delay_usec(interval_usec);
+		tick.increment();
+	}
+}
+
+uint32_t GDScriptSamplingProfiler::_get_function_id(const Frame &p_frame) {
+	const void *key = p_frame.native ? (const void *)p_frame.native : (const void *)p_frame.function;
+	if (HashMap<const void *, uint32_t>::Iterator E = function_ids.find(key)) {
+		return E->value;
+	}
+
+	FunctionInfo info;
+	info.function = p_frame.function;
+	info.native = p_frame.native;
+	uint32_t id = functions.size();
+	functions.push_back(info);
+	function_ids.insert(key, id);
+	return id;
+}
+
+void GDScriptSamplingProfiler::_resolve_function(FunctionInfo &r_info) {
+	if (!r_info.name.is_empty()) {
+		return;
+	}
+	if (r_info.native) {
+		r_info.name = String(r_info.native->get_instance_class()) + "::" + String(r_info.native->get_name());
+	} else if (r_info.function) {
+		r_info.name = r_info.function->get_name();
+		r_info.source = r_info.function->get_source();
+	}
+}
+
+String GDScriptSamplingProfiler::_get_frame_text(const SampleFrame &p_frame) {
+	const FunctionInfo &info = functions[p_frame.function];
+	if (info.native) {
+		return info.name;
+	}
+	return info.name + " (" + _get_line_text(p_frame) + ")";
+}
+
+String GDScriptSamplingProfiler::_get_line_text(const SampleFrame &p_frame) {
+	return functions[p_frame.function].source + ":" + itos(p_frame.line);
+}
+
+void GDScriptSamplingProfiler::_record() {
+	ThreadStack &ts = thread_stack;
+	uint64_t current_tick = tick.get();
+	uint64_t count = current_tick - ts.last_tick;
+	ts.last_tick = current_tick;
+
+	if (ts.frames.is_empty()) {
+		return;
+	}
+
+	MutexLock lock(mutex);
+
+	// Frames are stored root first, as expected by flamegraph tools.
+	SampleStack &sample = ts.sample;
+	sample.frames.clear();
+	SampleFrame line;
+	for (const Frame &frame : ts.frames) {
+		SampleFrame sample_frame;
+		sample_frame.function = _get_function_id(frame);
+		if (!frame.native) {
+			sample_frame.line = *frame.line;
+			line = sample_frame;
+		}
+		sample.frames.push_back(sample_frame);
+	}
+
+	if (HashMap<SampleStack, uint64_t, SampleStackHasher>::Iterator E = stack_samples.find(sample)) {
+		E->value += count;
+	} else {
+		stack_samples.insert(sample, count);
+	}
+	// Attribute the sample to the innermost script line, even when it is spent in a native call.
+	if (HashMap<SampleFrame, uint64_t, SampleFrameHasher>::Iterator E = line_samples.find(line)) {
+		E->value += count;
+	} else {
+		line_samples.insert(line, count);
+	}
+	total_samples += count;
+}
+
+void GDScriptSamplingProfiler::enter_function(const GDScriptFunction *p_function, const int *p_line) {
+	ThreadStack &ts = thread_stack;
+	if (ts.frames.is_empty()) {
+		// Time spent outside of scripts is not accounted for.
+		ts.last_tick = tick.get();
+	} else {
+		poll();
+	}
+	ts.frames.push_back({ p_function, p_line, nullptr });
+}
+
+void GDScriptSamplingProfiler::exit_function() {
+	ThreadStack &ts = thread_stack;
+	ERR_FAIL_COND(ts.frames.is_empty());
+	poll();
+	ts.frames.resize(ts.frames.size() - 1);
+}
+
+void GDScriptSamplingProfiler::enter_native(const MethodBind *p_method) {
+	ThreadStack &ts = thread_stack;
+	poll();
+	ts.frames.push_back({ nullptr, nullptr, p_method });
+}
+
+void GDScriptSamplingProfiler::exit_native() {
+	ThreadStack &ts = thread_stack;
+	ERR_FAIL_COND(ts.frames.is_empty());
+	poll();
+	ts.frames.resize(ts.frames.size() - 1);
+}
+
+void GDScriptSamplingProfiler::function_freed(const GDScriptFunction *p_function) {
+	MutexLock lock(mutex);
+	HashMap<const void *, uint32_t>::Iterator E = function_ids.find(p_function);
+	if (!E) {
+		return;
+	}
+
+	// Keep the name around for the results, and let a new function reuse the address.
+	FunctionInfo &info = functions[E->value];
+	_resolve_function(info);
+	info.function = nullptr;
+	function_ids.remove(E);
+}
+
+void GDScriptSamplingProfiler::start(uint64_t p_interval_usec) {
+	ERR_FAIL_COND_MSG(active.is_set(), "The GDScript sampling profiler is already running.");
+	interval_usec = MAX(p_interval_usec, (uint64_t)1);
+	exit_thread.clear();
+	sampler_thread.start(_sampler_thread_func, nullptr);
+	active.set();
+}
+
+void GDScriptSamplingProfiler::stop() {
+	if (!active.is_set()) {
+		return;
+	}
+	active.clear();
+	exit_thread.set();
+	sampler_thread.wait_to_finish();
+
+	// Frames pushed while active are still popped by the VM, but free the
+	// calling thread's buffer now rather than at thread exit.
+	if (thread_stack.frames.is_empty()) {
+		thread_stack.frames.reset();
+	}
+}
+
+void GDScriptSamplingProfiler::clear() {
+	MutexLock lock(mutex);
+	stack_samples.clear();
+	line_samples.clear();
+	functions.clear();
+	function_ids.clear();
+	total_samples = 0;
+}
+
+uint64_t GDScriptSamplingProfiler::get_total_samples() {
+	MutexLock lock(mutex);
+	return total_samples;
+}
+
+Error GDScriptSamplingProfiler::save_folded(const String &p_path) {
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot open file '" + p_path + "' to save the GDScript profile.");
+
+	MutexLock lock(mutex);
+	for (FunctionInfo &info : functions) {
+		_resolve_function(info);
+	}
+
+	// Frames are separated by ';', root first.
+	LocalVector<String> stacks;
+	stacks.reserve(stack_samples.size());
+	for (const KeyValue<SampleStack, uint64_t> &E : stack_samples) {
+		String stack;
+		for (const SampleFrame &frame : E.key.frames) {
+			if (!stack.is_empty()) {
+				stack += ";";
+			}
+			stack += _get_frame_text(frame);
+		}
+		stacks.push_back(stack + " " + itos(E.value));
+	}
+	stacks.sort();
+
+	for (const String &stack : stacks) {
+		f->store_line(stack);
+	}
+
+	return OK;
+}
+
+void GDScriptSamplingProfiler::print_hot_lines(int p_max_lines) {
+	struct LineSamples {
+		String line;
+		uint64_t count = 0;
+
+		bool operator<(const LineSamples &p_other) const {
+			return count > p_other.count || (count == p_other.count && line < p_other.line);
+		}
+	};
+
+	MutexLock lock(mutex);
+	if (total_samples == 0) {
+		print_line("GDScript sampling profiler: no samples were taken.");
+		return;
+	}
+
+	for (FunctionInfo &info : functions) {
+		_resolve_function(info);
+	}
+
+	LocalVector<LineSamples> lines;
+	lines.reserve(line_samples.size());
+	for (const KeyValue<SampleFrame, uint64_t> &E : line_samples) {
+		lines.push_back({ _get_line_text(E.key), E.value });
+	}
+	lines.sort();
+
+	print_line(vformat("GDScript sampling profiler: %d samples, %d usec interval.", total_samples, interval_usec));
+	for (uint32_t i = 0; i < MIN(lines.size(), (uint32_t)p_max_lines); i++) {
+		print_line(vformat("%6.2f%% %8d  %s", 100.0 * lines[i].count / total_samples, lines[i].count, lines[i].line));
+	}
+}
+
+#endif // DEBUG_ENABLED
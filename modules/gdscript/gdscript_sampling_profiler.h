@@ -0,0 +1,148 @@
+/**************************************************************************/
+/*  gdscript_sampling_profiler.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_SAMPLING_PROFILER_H
+#define GDSCRIPT_SAMPLING_PROFILER_H
+
+#ifdef DEBUG_ENABLED
+
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+class GDScriptFunction;
+class MethodBind;
+
+// Statistical profiler for GDScript. A background thread advances a tick counter
+// at a fixed interval, and the VM attributes elapsed ticks to its current call
+// stack (including the native method being called, if any) the next time it
+// reaches a line or a native call boundary. Results can be saved in the
+// collapsed stack format used by flamegraph tools.
+//
+// Native frames are only pushed for method bind calls (including static and
+// validated ones). Time spent in other native code, such as utility functions,
+// builtin type methods or generic Variant calls, is attributed to the calling
+// script line.
+class GDScriptSamplingProfiler {
+	struct Frame {
+		const GDScriptFunction *function = nullptr;
+		const int *line = nullptr;
+		const MethodBind *native = nullptr;
+	};
+
+	// Frame as stored in the aggregated samples: an index into `functions` and
+	// the line being run, or -1 for native frames.
+	struct SampleFrame {
+		uint32_t function = 0;
+		int line = -1;
+
+		bool operator==(const SampleFrame &p_other) const { return function == p_other.function && line == p_other.line; }
+	};
+
+	struct SampleFrameHasher {
+		static _FORCE_INLINE_ uint32_t hash(const SampleFrame &p_frame) { return hash_fmix32(hash_murmur3_one_32(p_frame.line, p_frame.function)); }
+	};
+
+	struct SampleStack {
+		LocalVector<SampleFrame> frames;
+
+		bool operator==(const SampleStack &p_other) const;
+	};
+
+	struct SampleStackHasher {
+		static uint32_t hash(const SampleStack &p_stack);
+	};
+
+	// Names are only built when the results are printed or saved, or when a
+	// sampled function is freed before that.
+	struct FunctionInfo {
+		const GDScriptFunction *function = nullptr;
+		const MethodBind *native = nullptr;
+		String name;
+		String source;
+	};
+
+	struct ThreadStack {
+		LocalVector<Frame> frames;
+		SampleStack sample;
+		uint64_t last_tick = 0;
+	};
+
+	static thread_local ThreadStack thread_stack;
+
+	static SafeFlag active;
+	static SafeFlag exit_thread;
+	static SafeNumeric<uint64_t> tick;
+	static uint64_t interval_usec;
+	static Thread sampler_thread;
+
+	static Mutex mutex;
+	static LocalVector<FunctionInfo> functions;
+	static HashMap<const void *, uint32_t> function_ids;
+	static HashMap<SampleStack, uint64_t, SampleStackHasher> stack_samples;
+	static HashMap<SampleFrame, uint64_t, SampleFrameHasher> line_samples;
+	static uint64_t total_samples;
+
+	static void _sampler_thread_func(void *p_userdata);
+	static void _record();
+	static uint32_t _get_function_id(const Frame &p_frame);
+	static void _resolve_function(FunctionInfo &r_info);
+	static String _get_frame_text(const SampleFrame &p_frame);
+	static String _get_line_text(const SampleFrame &p_frame);
+
+public:
+	_FORCE_INLINE_ static bool is_active() { return active.is_set(); }
+
+	_FORCE_INLINE_ static void poll() {
+		if (unlikely(tick.get() != thread_stack.last_tick)) {
+			_record();
+		}
+	}
+
+	static void enter_function(const GDScriptFunction *p_function, const int *p_line);
+	static void exit_function();
+	static void enter_native(const MethodBind *p_method);
+	static void exit_native();
+	static void function_freed(const GDScriptFunction *p_function);
+
+	static void start(uint64_t p_interval_usec = 1000);
+	static void stop();
+	static void clear();
+
+	static uint64_t get_total_samples();
+	static Error save_folded(const String &p_path);
+	static void print_hot_lines(int p_max_lines = 20);
+};
+
+#endif // DEBUG_ENABLED
+
+#endif // GDSCRIPT_SAMPLING_PROFILER_H
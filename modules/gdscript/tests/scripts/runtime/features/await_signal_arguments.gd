@@ -0,0 +1,36 @@
+signal no_args
+signal one_arg(value)
+signal two_args(a, b)
+
+func wait_no_args():
+	var result = await no_args
+	print(result)
+
+func wait_one_arg():
+	var result = await one_arg
+	print(result)
+
+func wait_two_args():
+	var result = await two_args
+	print(result)
+
+func wait_in_loop():
+	var sum := 0
+	for i in 3:
+		sum += await one_arg
+	print(sum)
+
+func test():
+	wait_no_args()
+	no_args.emit()
+
+	wait_one_arg()
+	one_arg.emit(1)
+
+	wait_two_args()
+	two_args.emit(2, "b")
+
+	wait_in_loop()
+	one_arg.emit(10)
+	one_arg.emit(20)
+	one_arg.emit(30)
@@ -0,0 +1,99 @@
+/**************************************************************************/
+/*  test_sampling_profiler.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SAMPLING_PROFILER_H
+#define TEST_SAMPLING_PROFILER_H
+
+#if defined(DEBUG_ENABLED) && defined(TOOLS_ENABLED)
+
+#include "../gdscript.h"
+#include "../gdscript_sampling_profiler.h"
+
+#include "core/io/file_access.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+TEST_CASE("[Modules][GDScript] Sampling profiler saves collapsed stacks") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+func busy():
+	var total := 0
+	for i in 10000:
+		total += i
+	return total
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE(error == OK);
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+
+	GDScriptSamplingProfiler::clear();
+	GDScriptSamplingProfiler::start(100);
+	// Sampling is statistical, keep running the script until something is recorded.
+	const uint64_t start_time = OS::get_singleton()->get_ticks_msec();
+	while (GDScriptSamplingProfiler::get_total_samples() == 0 && OS::get_singleton()->get_ticks_msec() - start_time < 10000) {
+		ref_counted->call("busy");
+	}
+	GDScriptSamplingProfiler::stop();
+	REQUIRE(GDScriptSamplingProfiler::get_total_samples() > 0);
+
+	// Functions freed before saving keep their names.
+	ref_counted.unref();
+	gdscript.unref();
+
+	const String path = OS::get_singleton()->get_cache_path().path_join("gdscript_profile.folded");
+	CHECK(GDScriptSamplingProfiler::save_folded(path) == OK);
+	GDScriptSamplingProfiler::clear();
+
+	const Vector<String> lines = FileAccess::get_file_as_string(path).strip_edges().split("\n");
+	REQUIRE(lines.size() > 0);
+	uint64_t saved_samples = 0;
+	for (const String &line : lines) {
+		CHECK_MESSAGE(line.begins_with("busy (:"), "Every stack should start in the script function.");
+		const String count = line.get_slice(" ", line.get_slice_count(" ") - 1);
+		CHECK(count.is_valid_int());
+		saved_samples += count.to_int();
+	}
+	CHECK(saved_samples > 0);
+}
+
+} // namespace GDScriptTests
+
+#endif // DEBUG_ENABLED && TOOLS_ENABLED
+
+#endif // TEST_SAMPLING_PROFILER_H
@@ -30,6 +30,7 @@
 
 #include "register_types.h"
 
+#include "core/config/project_settings.h"
 #include "lightmap_raycaster_embree.h"
 #include "raycast_occlusion_cull.h"
 #include "static_raycaster_embree.h"
@@ -45,7 +46,9 @@ void initialize_raycast_module(ModuleInitializationLevel p_level) {
 	LightmapRaycasterEmbree::make_default_raycaster();
 	StaticRaycasterEmbree::make_default_raycaster();
 #endif
-	raycast_occlusion_cull = memnew(RaycastOcclusionCull);
+	if (!bool(GLOBAL_GET("rendering/occlusion_culling/use_software_rasterizer"))) {
+		raycast_occlusion_cull = memnew(RaycastOcclusionCull);
+	}
 }
 
 void uninitialize_raycast_module(ModuleInitializationLevel p_level) {
@@ -55,6 +58,7 @@ void uninitialize_raycast_module(ModuleInitializationLevel p_level) {
 
 	if (raycast_occlusion_cull) {
 		memdelete(raycast_occlusion_cull);
+		raycast_occlusion_cull = nullptr;
 	}
 #ifdef TOOLS_ENABLED
 	StaticRaycasterEmbree::free();
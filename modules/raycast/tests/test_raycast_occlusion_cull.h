@@ -0,0 +1,143 @@
+/**************************************************************************/
+/*  test_raycast_occlusion_cull.h                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RAYCAST_OCCLUSION_CULL_H
+#define TEST_RAYCAST_OCCLUSION_CULL_H
+
+#ifdef TOOLS_ENABLED
+
+#include "../static_raycaster_embree.h"
+
+#include "servers/rendering/renderer_scene_occlusion_raster.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRaycastOcclusionCull {
+
+// Filled like RaycastOcclusionCull fills its buffers, with a ray through each pixel center and the
+// hit distance along the camera direction. The scene is committed synchronously here, where
+// RaycastOcclusionCull does it on a thread and only uses it on a later frame.
+class EmbreeHZBuffer : public RendererSceneOcclusionCull::HZBuffer {
+public:
+	void raycast(StaticRaycaster *p_raycaster, const Transform3D &p_cam_transform, const Projection &p_cam_projection) {
+		const Size2i &size = sizes[0];
+		const Projection inv_projection = p_cam_projection.inverse();
+		const Vector3 cam_dir = -p_cam_transform.basis.get_column(2).normalized();
+
+		for (int y = 0; y < size.y; y++) {
+			for (int x = 0; x < size.x; x++) {
+				const Vector3 near_point = inv_projection.xform(Vector3((x + 0.5f) / size.x * 2.0f - 1.0f, (y + 0.5f) / size.y * 2.0f - 1.0f, -1.0f));
+				const Vector3 dir = p_cam_transform.basis.xform(near_point).normalized();
+				StaticRaycaster::Ray ray(p_cam_transform.origin, dir, 0.0f, p_cam_projection.get_z_far());
+				p_raycaster->intersect(ray);
+				mips[0][y * size.x + x] = ray.tfar * dir.dot(cam_dir);
+			}
+		}
+
+		update_mips();
+	}
+};
+
+TEST_CASE("[RaycastOcclusionCull] Software rasterizer agrees with Embree") {
+	// A 4x4x1 box, 5 units in front of the origin.
+	const AABB box = AABB(Vector3(-2, -2, -5.5), Vector3(4, 4, 1));
+	PackedVector3Array vertices;
+	PackedInt32Array indices;
+	for (int i = 0; i < 8; i++) {
+		vertices.push_back(box.get_endpoint(i));
+	}
+	// Two triangles per face. Endpoint indices have one bit per axis: Z is the lowest, then Y and X.
+	const int faces[6][4] = { { 0, 1, 3, 2 }, { 4, 6, 7, 5 }, { 0, 4, 5, 1 }, { 2, 3, 7, 6 }, { 0, 2, 6, 4 }, { 1, 5, 7, 3 } };
+	for (const int *face : faces) {
+		const int triangles[6] = { face[0], face[1], face[2], face[0], face[2], face[3] };
+		for (int index : triangles) {
+			indices.push_back(index);
+		}
+	}
+
+	Ref<StaticRaycasterEmbree> raycaster;
+	raycaster.instantiate();
+	raycaster->add_mesh(vertices, indices, 0);
+	raycaster->commit();
+
+	RendererSceneOcclusionRaster occlusion_cull;
+	const RID occluder = occlusion_cull.occluder_allocate();
+	occlusion_cull.occluder_initialize(occluder);
+	occlusion_cull.occluder_set_mesh(occluder, vertices, indices);
+	const RID scenario = RID::from_uint64(1);
+	const RID instance = RID::from_uint64(2);
+	const RID buffer = RID::from_uint64(3);
+	occlusion_cull.add_scenario(scenario);
+	occlusion_cull.scenario_set_instance(scenario, instance, occluder, Transform3D(), true);
+	occlusion_cull.add_buffer(buffer);
+	occlusion_cull.buffer_set_scenario(buffer, scenario);
+	occlusion_cull.buffer_set_size(buffer, Size2i(64, 64));
+
+	EmbreeHZBuffer embree_buffer;
+	embree_buffer.resize(Size2i(64, 64));
+
+	const Projection cam_projection = Projection::create_perspective(90, 1.0, 0.1, 100);
+	const Transform3D cam_transforms[2] = {
+		Transform3D(),
+		Transform3D(Basis(), Vector3(3, 2, 0)).looking_at(Vector3(0, 0, -5)),
+	};
+
+	for (const Transform3D &cam_transform : cam_transforms) {
+		occlusion_cull.buffer_update(buffer, cam_transform, cam_projection, false);
+		const RendererSceneOcclusionCull::HZBuffer *raster_buffer = occlusion_cull.buffer_get_ptr(buffer);
+		REQUIRE(raster_buffer);
+		embree_buffer.raycast(raycaster.ptr(), cam_transform, cam_projection);
+
+		const Transform3D cam_inv_transform = cam_transform.affine_inverse();
+		int occluded_count = 0;
+		for (int z = -20; z <= -3; z += 7) {
+			for (int y = -12; y <= 12; y += 3) {
+				for (int x = -12; x <= 12; x += 3) {
+					const real_t bounds[6] = { x - 0.5f, y - 0.5f, z - 0.5f, x + 0.5f, y + 0.5f, z + 0.5f };
+					const bool embree_occluded = embree_buffer.is_occluded(bounds, cam_transform.origin, cam_inv_transform, cam_projection, cam_projection.get_z_near());
+					const bool raster_occluded = raster_buffer->is_occluded(bounds, cam_transform.origin, cam_inv_transform, cam_projection, cam_projection.get_z_near());
+					CHECK_MESSAGE(raster_occluded == embree_occluded, vformat("Occlusion of the box at %v should match.", Vector3(x, y, z)));
+					occluded_count += raster_occluded ? 1 : 0;
+				}
+			}
+		}
+		CHECK_MESSAGE(occluded_count > 0, "Some boxes should be behind the occluder.");
+	}
+
+	occlusion_cull.remove_buffer(buffer);
+	occlusion_cull.scenario_remove_instance(scenario, instance);
+	occlusion_cull.remove_scenario(scenario);
+	occlusion_cull.free_occluder(occluder);
+}
+} // namespace TestRaycastOcclusionCull
+
+#endif // TOOLS_ENABLED
+
+#endif // TEST_RAYCAST_OCCLUSION_CULL_H
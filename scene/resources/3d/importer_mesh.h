@@ -32,6 +32,7 @@
 #define IMPORTER_MESH_H
 
 #include "core/io/resource.h"
+#include "core/math/static_raycaster.h"
 #include "core/templates/local_vector.h"
 #include "scene/resources/3d/concave_polygon_shape_3d.h"
 #include "scene/resources/3d/convex_polygon_shape_3d.h"
@@ -82,6 +83,38 @@ class ImporterMesh : public Resource {
 
 	Size2i lightmap_size_hint;
 
+	static constexpr uint32_t INTERSECT_RAYS_CHUNK_SIZE = 256;
+
+	struct GenerateLODsData {
+		float normal_merge_angle = 0.0f;
+		float normal_split_angle = 0.0f;
+		LocalVector<Transform3D> bone_transforms;
+		LocalVector<int> surfaces;
+	};
+
+	struct IntersectRaysData {
+		StaticRaycaster *raycaster = nullptr;
+		StaticRaycaster::Ray *rays = nullptr;
+		uint32_t ray_count = 0;
+	};
+
+	struct OptimizeLODsData {
+		Surface *surface = nullptr;
+		unsigned int vertex_count = 0;
+	};
+
+	struct ShadowSurface {
+		Array arrays;
+		Dictionary lods;
+		bool valid = false;
+	};
+
+	void _generate_surface_lods(int p_surface, const GenerateLODsData &p_data, bool p_use_threads);
+	void _generate_surface_lods_threaded(uint32_t p_index, GenerateLODsData *p_data);
+	void _intersect_rays_threaded(uint32_t p_chunk, IntersectRaysData *p_data);
+	void _optimize_lod_vertex_cache_threaded(uint32_t p_lod, OptimizeLODsData *p_data);
+	void _create_shadow_surface_threaded(uint32_t p_surface, ShadowSurface *p_shadow_surfaces);
+
 protected:
 	void _set_data(const Dictionary &p_data);
 	Dictionary _get_data() const;
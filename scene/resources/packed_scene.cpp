@@ -35,6 +35,8 @@
 #include "core/core_string_names.h"
 #include "core/io/missing_resource.h"
 #include "core/io/resource_loader.h"
+#include "core/object/method_bind.h"
+#include "core/object/script_language.h"
 #include "core/templates/local_vector.h"
 #include "scene/2d/node_2d.h"
 #ifndef _3D_DISABLED
@@ -125,6 +127,94 @@ Ref<Resource> SceneState::get_remap_resource(const Ref<Resource> &p_resource, Ha
 	return remap_resource;
 }
 
+void SceneState::_build_instantiate_plan() const {
+	MutexLock lock(instantiate_plan_mutex);
+	if (instantiate_plan_built.is_set()) {
+		return;
+	}
+
+	const StringName &script_name = CoreStringNames::get_singleton()->_script;
+	const int sname_count = names.size();
+	const int prop_count = variants.size();
+
+	instantiate_plan.nodes.resize(nodes.size());
+	for (int i = 0; i < nodes.size(); i++) {
+		const NodeData &n = nodes[i];
+		InstantiatePlan::NodePlan &node_plan = instantiate_plan.nodes[i];
+
+		if ((i == 0 && base_scene_idx >= 0) || n.instance >= 0 || n.type == TYPE_INSTANTIATED || n.type < 0 || n.type >= sname_count) {
+			continue; // Not created from ClassDB, properties go through Object::set().
+		}
+
+		node_plan.class_name = names[n.type];
+		node_plan.setters.resize(n.properties.size());
+
+		Ref<Script> script;
+		for (const NodeData::Property &prop : n.properties) {
+			if (prop.name >= 0 && prop.name < sname_count && prop.value >= 0 && prop.value < prop_count && names[prop.name] == script_name) {
+				script = variants[prop.value];
+			}
+		}
+
+		// A script can intercept any property from _set(), in which case the setters can't be used once it's attached.
+		HashSet<StringName> script_properties;
+		if (script.is_valid()) {
+			bool intercepts = false;
+			for (Ref<Script> base = script; base.is_valid() && !intercepts; base = base->get_base_script()) {
+				intercepts = base->has_method(SNAME("_set"));
+			}
+			if (!intercepts) {
+				node_plan.script = script.ptr();
+			}
+
+			List<PropertyInfo> script_property_list;
+			script->get_script_property_list(&script_property_list);
+			for (const PropertyInfo &E : script_property_list) {
+				script_properties.insert(E.name);
+			}
+		}
+
+		for (int j = 0; j < n.properties.size(); j++) {
+			const NodeData::Property &prop = n.properties[j];
+			if ((prop.name & FLAG_PATH_PROPERTY_IS_NODE) || prop.name < 0 || prop.name >= sname_count) {
+				continue;
+			}
+
+			const StringName &prop_name = names[prop.name];
+			if (prop_name == script_name || script_properties.has(prop_name)) {
+				continue;
+			}
+
+			InstantiatePlan::Setter &setter = node_plan.setters[j];
+			setter.method = ClassDB::get_property_setter_method(node_plan.class_name, prop_name, &setter.index);
+		}
+	}
+
+	instantiate_plan.connection_binds.resize(connections.size());
+	for (int i = 0; i < connections.size(); i++) {
+		const ConnectionData &c = connections[i];
+		Vector<Variant> &binds = instantiate_plan.connection_binds[i];
+		binds.resize(c.binds.size());
+		for (int j = 0; j < c.binds.size(); j++) {
+			ERR_CONTINUE(c.binds[j] < 0 || c.binds[j] >= prop_count);
+			binds.write[j] = variants[c.binds[j]];
+		}
+	}
+
+	instantiate_plan_built.set();
+}
+
+void SceneState::_clear_instantiate_plan() {
+	if (!instantiate_plan_built.is_set()) {
+		return;
+	}
+
+	MutexLock lock(instantiate_plan_mutex);
+	instantiate_plan.nodes.clear();
+	instantiate_plan.connection_binds.clear();
+	instantiate_plan_built.clear();
+}
+
 Node *SceneState::instantiate(GenEditState p_edit_state) const {
 	// Nodes where instantiation failed (because something is missing.)
 	List<Node *> stray_instances;
@@ -166,6 +256,15 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 
 	LocalVector<DeferredNodePathProperties> deferred_node_paths;
 
+	// The editor may swap in placeholder scripts and classes, keep it on the generic path.
+	const InstantiatePlan *plan = nullptr;
+	if (p_edit_state == GEN_EDIT_STATE_DISABLED && !Engine::get_singleton()->is_editor_hint()) {
+		if (!instantiate_plan_built.is_set()) {
+			_build_instantiate_plan();
+		}
+		plan = &instantiate_plan;
+	}
+
 	for (int i = 0; i < nc; i++) {
 		const NodeData &n = nd[i];
 
@@ -305,6 +404,11 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 			if (nprop_count) {
 				const NodeData::Property *nprops = &n.properties[0];
 
+				const InstantiatePlan::NodePlan *node_plan = nullptr;
+				if (plan && plan->nodes[i].class_name != StringName() && node->get_class_name() == plan->nodes[i].class_name) {
+					node_plan = &plan->nodes[i];
+				}
+
 				Dictionary missing_resource_properties;
 				HashMap<Ref<Resource>, Ref<Resource>> resources_local_to_sub_scene; // Record the mappings in the sub-scene.
 
@@ -399,7 +503,23 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 						}
 
 						if (set_valid) {
-							node->set(snames[nprops[j].name], value, &valid);
+							const InstantiatePlan::Setter *setter = node_plan ? &node_plan->setters[j] : nullptr;
+							ScriptInstance *si = setter && setter->method ? node->get_script_instance() : nullptr;
+							if (setter && setter->method && (!si || si->get_script().ptr() == node_plan->script)) {
+								// Same call ClassDB::set_property() would end up making.
+								Callable::CallError ce;
+								if (setter->index >= 0) {
+									Variant index = setter->index;
+									const Variant *args[2] = { &index, &value };
+									setter->method->call(node, args, 2, ce);
+								} else {
+									const Variant *args[1] = { &value };
+									setter->method->call(node, args, 1, ce);
+								}
+								valid = ce.error == Callable::CallError::CALL_OK;
+							} else {
+								node->set(snames[nprops[j].name], value, &valid);
+							}
 						}
 						if (p_edit_state == GEN_EDIT_STATE_INSTANCE && value.get_type() != Variant::OBJECT) {
 							value = value.duplicate(true); // Duplicate arrays and dictionaries for the editor.
@@ -556,7 +676,9 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 			callable = callable.unbind(c.unbinds);
 		} else if (!c.binds.is_empty()) {
 			Vector<Variant> binds;
-			if (c.binds.size()) {
+			if (plan) {
+				binds = plan->connection_binds[i];
+			} else if (c.binds.size()) {
 				binds.resize(c.binds.size());
 				for (int j = 0; j < c.binds.size(); j++) {
 					binds.write[j] = props[c.binds[j]];
@@ -1199,6 +1321,7 @@ String SceneState::get_path() const {
 }
 
 void SceneState::clear() {
+	_clear_instantiate_plan();
 	names.clear();
 	variants.clear();
 	nodes.clear();
@@ -1254,6 +1377,8 @@ Ref<SceneState> SceneState::get_base_scene_state() const {
 void SceneState::update_instance_resource(String p_path, Ref<PackedScene> p_packed_scene) {
 	ERR_FAIL_COND(p_packed_scene.is_null());
 
+	_clear_instantiate_plan();
+
 	for (const NodeData &nd : nodes) {
 		if (nd.instance >= 0) {
 			if (!(nd.instance & FLAG_INSTANCE_IS_PLACEHOLDER)) {
@@ -1416,6 +1541,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 
 	ERR_FAIL_COND_MSG(version > PACKED_SCENE_VERSION, "Save format version too new.");
 
+	_clear_instantiate_plan();
+
 	const int node_count = p_dictionary["node_count"];
 	const Vector<int> snodes = p_dictionary["nodes"];
 	ERR_FAIL_COND(snodes.size() < node_count);
@@ -1867,11 +1994,13 @@ Vector<NodePath> SceneState::get_editable_instances() const {
 //add
 
 int SceneState::add_name(const StringName &p_name) {
+	_clear_instantiate_plan();
 	names.push_back(p_name);
 	return names.size() - 1;
 }
 
 int SceneState::add_value(const Variant &p_value) {
+	_clear_instantiate_plan();
 	variants.push_back(p_value);
 	return variants.size() - 1;
 }
@@ -1882,6 +2011,7 @@ int SceneState::add_node_path(const NodePath &p_path) {
 }
 
 int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int p_instance, int p_index) {
+	_clear_instantiate_plan();
 	NodeData nd;
 	nd.parent = p_parent;
 	nd.owner = p_owner;
@@ -1900,6 +2030,8 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value, bool p_d
 	ERR_FAIL_INDEX(p_name, names.size());
 	ERR_FAIL_INDEX(p_value, variants.size());
 
+	_clear_instantiate_plan();
+
 	NodeData::Property prop;
 	prop.name = p_name;
 	if (p_deferred_node_path) {
@@ -1917,6 +2049,7 @@ void SceneState::add_node_group(int p_node, int p_group) {
 
 void SceneState::set_base_scene(int p_idx) {
 	ERR_FAIL_INDEX(p_idx, variants.size());
+	_clear_instantiate_plan();
 	base_scene_idx = p_idx;
 }
 
@@ -1927,6 +2060,8 @@ void SceneState::add_connection(int p_from, int p_to, int p_signal, int p_method
 	for (int i = 0; i < p_binds.size(); i++) {
 		ERR_FAIL_INDEX(p_binds[i], variants.size());
 	}
+	_clear_instantiate_plan();
+
 	ConnectionData c;
 	c.from = p_from;
 	c.to = p_to;
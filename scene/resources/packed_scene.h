@@ -32,6 +32,9 @@
 #define PACKED_SCENE_H
 
 #include "core/io/resource.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "scene/main/node.h"
 
 class SceneState : public RefCounted {
@@ -89,6 +92,32 @@ class SceneState : public RefCounted {
 
 	Vector<ConnectionData> connections;
 
+	// Resolved once on first instantiation and replayed afterwards, so that
+	// properties of nodes created from ClassDB are set through their bound
+	// setter instead of a by-name lookup in Object::set().
+	struct InstantiatePlan {
+		struct Setter {
+			MethodBind *method = nullptr; // If null, use Object::set().
+			int index = -1;
+		};
+
+		struct NodePlan {
+			StringName class_name; // Empty if the node is not created from ClassDB.
+			const Object *script = nullptr; // Script whose instance is known not to intercept the setters.
+			LocalVector<Setter> setters; // One per entry in NodeData::properties.
+		};
+
+		LocalVector<NodePlan> nodes;
+		LocalVector<Vector<Variant>> connection_binds;
+	};
+
+	mutable InstantiatePlan instantiate_plan;
+	mutable SafeFlag instantiate_plan_built;
+	mutable Mutex instantiate_plan_mutex;
+
+	void _build_instantiate_plan() const;
+	void _clear_instantiate_plan();
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, HashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, HashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map);
 
@@ -32,16 +32,18 @@
 
 #include "core/config/project_settings.h"
 #include "core/io/dir_access.h"
+#include "core/io/file_access_memory.h"
 #include "core/io/missing_resource.h"
 #include "core/io/resource_format_binary.h"
 #include "core/object/script_language.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/version.h"
 
 // Version 2: changed names for Basis, AABB, Vectors, etc.
 // Version 3: new string ID for ext/subresources, breaks forward compat.
 #define FORMAT_VERSION 3
 
-#define BINARY_FORMAT_VERSION 4
+#define BINARY_FORMAT_VERSION 6
 
 #include "core/io/dir_access.h"
 #include "core/version.h"
@@ -149,41 +151,75 @@ Error ResourceLoaderText::_parse_ext_resource(VariantParser::Stream *p_stream, R
 			return ERR_PARSE_ERROR;
 		}
 
-		String path = ext_resources[id].path;
-		String type = ext_resources[id].type;
-		Ref<ResourceLoader::LoadToken> &load_token = ext_resources[id].load_token;
+		err = _get_ext_resource(id, r_res);
+	}
 
-		if (load_token.is_valid()) { // If not valid, it's OK since then we know this load accepts broken dependencies.
-			Ref<Resource> res = ResourceLoader::_load_complete(*load_token.ptr(), &err);
-			if (res.is_null()) {
-				if (!ResourceLoader::is_cleaning_tasks()) {
-					if (ResourceLoader::get_abort_on_missing_resources()) {
-						error = ERR_FILE_MISSING_DEPENDENCIES;
-						error_text = "[ext_resource] referenced non-existent resource at: " + path;
-						_printerr();
-						err = error;
-					} else {
-						ResourceLoader::notify_dependency_error(local_path, path, type);
-					}
+	VariantParser::get_token(p_stream, token, line, r_err_str);
+	if (token.type != VariantParser::TK_PARENTHESIS_CLOSE) {
+		r_err_str = "Expected ')'";
+		return ERR_PARSE_ERROR;
+	}
+
+	return err;
+}
+
+Error ResourceLoaderText::_get_ext_resource(const String &p_id, Ref<Resource> &r_res) {
+	Error err = OK;
+
+	String path = ext_resources[p_id].path;
+	String type = ext_resources[p_id].type;
+	Ref<ResourceLoader::LoadToken> &load_token = ext_resources[p_id].load_token;
+
+	if (load_token.is_valid()) { // If not valid, it's OK since then we know this load accepts broken dependencies.
+		Ref<Resource> res = ResourceLoader::_load_complete(*load_token.ptr(), &err);
+		if (res.is_null()) {
+			if (!ResourceLoader::is_cleaning_tasks()) {
+				if (ResourceLoader::get_abort_on_missing_resources()) {
+					error = ERR_FILE_MISSING_DEPENDENCIES;
+					error_text = "[ext_resource] referenced non-existent resource at: " + path;
+					_printerr();
+					err = error;
+				} else {
+					ResourceLoader::notify_dependency_error(local_path, path, type);
 				}
-			} else {
-#ifdef TOOLS_ENABLED
-				//remember ID for saving
-				res->set_id_for_path(local_path, id);
-#endif
-				r_res = res;
 			}
 		} else {
-			r_res = Ref<Resource>();
-		}
 #ifdef TOOLS_ENABLED
-		if (r_res.is_null()) {
-			// Hack to allow checking original path.
-			r_res.instantiate();
-			r_res->set_meta("__load_path__", ext_resources[id].path);
+			//remember ID for saving
+			res->set_id_for_path(local_path, p_id);
+#endif
+			r_res = res;
 		}
+	} else {
+		r_res = Ref<Resource>();
+	}
+#ifdef TOOLS_ENABLED
+	if (r_res.is_null()) {
+		// Hack to allow checking original path.
+		r_res.instantiate();
+		r_res->set_meta("__load_path__", path);
+	}
 #endif
+
+	return err;
+}
+
+// Used while parsing in parallel, when every external resource has been waited for already.
+Error ResourceLoaderText::_parse_resolved_ext_resource(VariantParser::Stream *p_stream, Ref<Resource> &r_res, int &line, String &r_err_str) {
+	VariantParser::Token token;
+	VariantParser::get_token(p_stream, token, line, r_err_str);
+	if (token.type != VariantParser::TK_NUMBER && token.type != VariantParser::TK_STRING) {
+		r_err_str = "Expected number (old style sub-resource index) or String (ext-resource ID)";
+		return ERR_PARSE_ERROR;
+	}
+
+	String id = token.value;
+	const Ref<Resource> *res = resolved_ext_resources.getptr(id);
+	if (!res) {
+		r_err_str = "Can't load cached ext-resource id: " + id;
+		return ERR_PARSE_ERROR;
 	}
+	r_res = *res;
 
 	VariantParser::get_token(p_stream, token, line, r_err_str);
 	if (token.type != VariantParser::TK_PARENTHESIS_CLOSE) {
@@ -191,7 +227,7 @@ Error ResourceLoaderText::_parse_ext_resource(VariantParser::Stream *p_stream, R
 		return ERR_PARSE_ERROR;
 	}
 
-	return err;
+	return OK;
 }
 
 Ref<PackedScene> ResourceLoaderText::_parse_node_tag(VariantParser::ResourceParser &parser) {
@@ -407,6 +443,351 @@ Ref<PackedScene> ResourceLoaderText::_parse_node_tag(VariantParser::ResourcePars
 	}
 }
 
+Error ResourceLoaderText::_create_sub_resource(const VariantParser::Tag &p_tag, Ref<Resource> &r_res, MissingResource *&r_missing_resource, bool &r_do_assign) {
+	if (!p_tag.fields.has("type")) {
+		error = ERR_FILE_CORRUPT;
+		error_text = "Missing 'type' in external resource tag";
+		_printerr();
+		return error;
+	}
+
+	if (!p_tag.fields.has("id")) {
+		error = ERR_FILE_CORRUPT;
+		error_text = "Missing 'id' in external resource tag";
+		_printerr();
+		return error;
+	}
+
+	String type = p_tag.fields["type"];
+	String id = p_tag.fields["id"];
+
+	String path = local_path + "::" + id;
+
+	//bool exists=ResourceCache::has(path);
+
+	Ref<Resource> res;
+	bool do_assign = false;
+
+	if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
+		//reuse existing
+		Ref<Resource> cache = ResourceCache::get_ref(path);
+		if (cache.is_valid() && cache->get_class() == type) {
+			res = cache;
+			res->reset_state();
+			do_assign = true;
+		}
+	}
+
+	MissingResource *missing_resource = nullptr;
+
+	if (res.is_null()) { //not reuse
+		Ref<Resource> cache = ResourceCache::get_ref(path);
+		if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && cache.is_valid()) { //only if it doesn't exist
+			//cached, do not assign
+			res = cache;
+		} else {
+			//create
+
+			Object *obj = ClassDB::instantiate(type);
+			if (!obj) {
+				if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
+					missing_resource = memnew(MissingResource);
+					missing_resource->set_original_class(type);
+					missing_resource->set_recording_properties(true);
+					obj = missing_resource;
+				} else {
+					error_text += "Can't create sub resource of type: " + type;
+					_printerr();
+					error = ERR_FILE_CORRUPT;
+					return error;
+				}
+			}
+
+			Resource *r = Object::cast_to<Resource>(obj);
+			if (!r) {
+				error_text += "Can't create sub resource of type, because not a resource: " + type;
+				_printerr();
+				error = ERR_FILE_CORRUPT;
+				return error;
+			}
+
+			res = Ref<Resource>(r);
+			do_assign = true;
+		}
+	}
+
+	resource_current++;
+
+	if (progress && resources_total > 0) {
+		*progress = resource_current / float(resources_total);
+	}
+
+	int_resources[id] = res; // Always assign int resources.
+	if (do_assign) {
+		if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
+			res->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE);
+		} else {
+			res->set_path_cache(path);
+		}
+		res->set_scene_unique_id(id);
+	}
+
+	r_res = res;
+	r_missing_resource = missing_resource;
+	r_do_assign = do_assign;
+	return OK;
+}
+
+void ResourceLoaderText::_set_resource_property(const Ref<Resource> &p_res, MissingResource *p_missing_resource, Dictionary &r_missing_resource_properties, const String &p_name, Variant &p_value) {
+	if (p_value.get_type() == Variant::OBJECT && p_missing_resource != nullptr) {
+		// If the property being set is a missing resource (and the parent is not),
+		// then setting it will most likely not work.
+		// Instead, save it as metadata.
+
+		Ref<MissingResource> mr = p_value;
+		if (mr.is_valid()) {
+			r_missing_resource_properties[p_name] = mr;
+			return;
+		}
+	}
+
+	if (p_value.get_type() == Variant::ARRAY) {
+		Array set_array = p_value;
+		bool is_get_valid = false;
+		Variant get_value = p_res->get(p_name, &is_get_valid);
+		if (is_get_valid && get_value.get_type() == Variant::ARRAY) {
+			Array get_array = get_value;
+			if (!set_array.is_same_typed(get_array)) {
+				p_value = Array(set_array, get_array.get_typed_builtin(), get_array.get_typed_class_name(), get_array.get_typed_script());
+			}
+		}
+	}
+
+	p_res->set(p_name, p_value);
+}
+
+// Finds the sections ('[' at the start of a line, outside of values) in p_text.
+static void _find_text_sections(const uint8_t *p_text, uint64_t p_len, int p_line, LocalVector<uint64_t> &r_starts, LocalVector<int> &r_lines) {
+	int depth = 0;
+	bool line_start = true;
+	for (uint64_t i = 0; i < p_len; i++) {
+		uint8_t c = p_text[i];
+		switch (c) {
+			case '\n': {
+				p_line++;
+				line_start = true;
+				continue;
+			}
+			case '"': {
+				for (i++; i < p_len && p_text[i] != '"'; i++) {
+					if (p_text[i] == '\\') {
+						i++;
+					} else if (p_text[i] == '\n') {
+						p_line++;
+					}
+				}
+			} break;
+			case ';': {
+				while (i + 1 < p_len && p_text[i + 1] != '\n') {
+					i++;
+				}
+			} break;
+			case '[': {
+				if (line_start && depth == 0) {
+					r_starts.push_back(i);
+					r_lines.push_back(p_line);
+				}
+				depth++;
+			} break;
+			case '(':
+			case '{': {
+				depth++;
+			} break;
+			case ']':
+			case ')':
+			case '}': {
+				depth = MAX(depth - 1, 0);
+			} break;
+		}
+		line_start = false;
+	}
+}
+
+// Inline Resource("...") and Object(...) constructors load or instantiate objects while parsing,
+// which is left to the loading thread.
+static bool _has_inline_object_constructor(const uint8_t *p_text, uint64_t p_len) {
+	static const char *constructors[] = { "Resource(", "Object(" };
+	for (const char *constructor : constructors) {
+		const uint64_t len = strlen(constructor);
+		for (uint64_t i = 0; i + len <= p_len; i++) {
+			if (p_text[i] == (uint8_t)constructor[0] && memcmp(p_text + i, constructor, len) == 0) {
+				if (i == 0 || !(is_ascii_identifier_char(p_text[i - 1]))) {
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+void ResourceLoaderText::_parse_sub_resource_section(uint32_t p_index, SubResourceSection *p_sections) {
+	SubResourceSection &section = p_sections[p_index];
+	if (!section.do_assign || section.from == section.to) {
+		return;
+	}
+
+	Ref<FileAccessMemory> body;
+	body.instantiate();
+	body->open_custom(text_buffer.ptr() + section.from, section.to - section.from);
+
+	VariantParser::StreamFile body_stream;
+	body_stream.f = body;
+
+	VariantParser::ResourceParser parser;
+	parser.userdata = this;
+	parser.ext_func = _parse_resolved_ext_resources;
+	parser.sub_func = _parse_sub_resources;
+
+	int line = section.line;
+	while (true) {
+		String assign;
+		Variant value;
+		VariantParser::Tag tag;
+
+		Error err = VariantParser::parse_tag_assign_eof(&body_stream, line, section.error_text, tag, assign, value, &parser);
+		if (err == ERR_FILE_EOF) {
+			break;
+		}
+		if (err != OK || assign.is_empty()) {
+			section.error = err != OK ? err : ERR_FILE_CORRUPT;
+			section.line = line;
+			return;
+		}
+		section.properties.push_back(Pair<String, Variant>(assign, value));
+	}
+}
+
+// Parses the bodies of consecutive [sub_resource] sections on the worker thread pool.
+// Sub-resources are created up-front, in file order, so references between them resolve
+// while parsing; properties are then set in file order, as when parsing sequentially.
+Error ResourceLoaderText::_load_sub_resources_in_parallel() {
+	if (ignore_resource_parsing || f->get_length() < PARALLEL_PARSE_MIN_SIZE || WorkerThreadPool::get_singleton()->get_thread_count() < 2) {
+		return OK;
+	}
+
+	text_buffer = stream.take_remaining();
+
+	Ref<FileAccessMemory> text_file;
+	text_file.instantiate();
+	text_file->open_custom(text_buffer.ptr(), text_buffer.size());
+	stream.f = text_file; // Sequential parsing continues from memory in any case.
+
+	const uint8_t *text = text_buffer.ptr();
+	LocalVector<uint64_t> starts;
+	LocalVector<int> start_lines;
+	_find_text_sections(text, text_buffer.size(), lines, starts, start_lines);
+
+	LocalVector<SubResourceSection> sections;
+	VariantParser::Tag tag = next_tag;
+	uint64_t body_from = 0;
+	int body_line = lines;
+	uint32_t assigned = 0;
+	bool ends_file = true;
+
+	for (uint32_t i = 0; i <= starts.size(); i++) {
+		SubResourceSection section;
+		section.tag = tag;
+		section.from = body_from;
+		section.to = i < starts.size() ? starts[i] : text_buffer.size();
+		section.line = body_line;
+		if (_has_inline_object_constructor(text + section.from, section.to - section.from)) {
+			text_file->seek(0);
+			return OK;
+		}
+		sections.push_back(section);
+
+		if (i == starts.size()) {
+			break;
+		}
+
+		VariantParser::StreamFile header_stream(false); // No readahead, to know where the body starts.
+		header_stream.f = text_file;
+		text_file->seek(starts[i]);
+		body_line = start_lines[i];
+		String header_error;
+		if (VariantParser::parse_tag(&header_stream, body_line, header_error, tag, &rp) != OK) {
+			// Leave reporting the error to the sequential parser.
+			text_file->seek(0);
+			return OK;
+		}
+		body_from = text_file->get_position() - (header_stream.saved ? 1 : 0);
+
+		if (tag.name != "sub_resource") {
+			ends_file = false;
+			break;
+		}
+	}
+
+	if (sections.size() < 2 || ends_file) {
+		text_file->seek(0);
+		return OK;
+	}
+
+	for (SubResourceSection &section : sections) {
+		error = _create_sub_resource(section.tag, section.res, section.missing_resource, section.do_assign);
+		if (error) {
+			return error;
+		}
+		if (section.do_assign) {
+			assigned++;
+		}
+	}
+
+	if (assigned) {
+		for (KeyValue<String, ExtResource> &E : ext_resources) {
+			Ref<Resource> res;
+			error = _get_ext_resource(E.key, res);
+			if (error) {
+				return error;
+			}
+			resolved_ext_resources[E.key] = res;
+		}
+
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &ResourceLoaderText::_parse_sub_resource_section, sections.ptr(), sections.size(), -1, true, SNAME("ResourceLoaderText"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		resolved_ext_resources.clear();
+	}
+
+	for (SubResourceSection &section : sections) {
+		if (section.error) {
+			error = section.error;
+			error_text = section.error_text;
+			lines = section.line;
+			_printerr();
+			return error;
+		}
+
+		Dictionary missing_resource_properties;
+		for (Pair<String, Variant> &property : section.properties) {
+			_set_resource_property(section.res, section.missing_resource, missing_resource_properties, property.first, property.second);
+		}
+
+		if (section.missing_resource) {
+			section.missing_resource->set_recording_properties(false);
+		}
+
+		if (!missing_resource_properties.is_empty()) {
+			section.res->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
+		}
+	}
+
+	// Resume sequential parsing after the header of the first section that isn't a sub-resource.
+	next_tag = tag;
+	lines = body_line;
+	text_file->seek(body_from);
+	return OK;
+}
+
 Error ResourceLoaderText::load() {
 	if (error != OK) {
 		return error;
@@ -469,9 +850,18 @@ Error ResourceLoaderText::load() {
 			path = remaps[path];
 		}
 
+		// Parse ahead first, to know whether this is the last dependency.
+		error = VariantParser::parse_tag(&stream, lines, error_text, next_tag, &rp);
+
+		if (error) {
+			_printerr();
+			return error;
+		}
+
+		ResourceLoader::LoadThreadMode thread_mode = ResourceLoader::_get_dependency_thread_mode(path, type, use_sub_threads, next_tag.name != "ext_resource");
 		ext_resources[id].path = path;
 		ext_resources[id].type = type;
-		ext_resources[id].load_token = ResourceLoader::_load_start(path, type, use_sub_threads ? ResourceLoader::LOAD_THREAD_DISTRIBUTE : ResourceLoader::LOAD_THREAD_FROM_CURRENT, cache_mode_for_external);
+		ext_resources[id].load_token = ResourceLoader::_load_start(path, type, thread_mode, cache_mode_for_external);
 		if (!ext_resources[id].load_token.is_valid()) {
 			if (ResourceLoader::get_abort_on_missing_resources()) {
 				error = ERR_FILE_CORRUPT;
@@ -483,13 +873,6 @@ Error ResourceLoaderText::load() {
 			}
 		}
 
-		error = VariantParser::parse_tag(&stream, lines, error_text, next_tag, &rp);
-
-		if (error) {
-			_printerr();
-			return error;
-		}
-
 		resource_current++;
 	}
 
@@ -497,97 +880,25 @@ Error ResourceLoaderText::load() {
 	resources_total -= resource_current;
 	resource_current = 0;
 
-	while (true) {
-		if (next_tag.name != "sub_resource") {
-			break;
-		}
-
-		if (!next_tag.fields.has("type")) {
-			error = ERR_FILE_CORRUPT;
-			error_text = "Missing 'type' in external resource tag";
-			_printerr();
+	if (next_tag.name == "sub_resource") {
+		error = _load_sub_resources_in_parallel();
+		if (error) {
 			return error;
 		}
+	}
 
-		if (!next_tag.fields.has("id")) {
-			error = ERR_FILE_CORRUPT;
-			error_text = "Missing 'id' in external resource tag";
-			_printerr();
-			return error;
+	while (true) {
+		if (next_tag.name != "sub_resource") {
+			break;
 		}
 
-		String type = next_tag.fields["type"];
-		String id = next_tag.fields["id"];
-
-		String path = local_path + "::" + id;
-
-		//bool exists=ResourceCache::has(path);
-
 		Ref<Resource> res;
-		bool do_assign = false;
-
-		if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
-			//reuse existing
-			Ref<Resource> cache = ResourceCache::get_ref(path);
-			if (cache.is_valid() && cache->get_class() == type) {
-				res = cache;
-				res->reset_state();
-				do_assign = true;
-			}
-		}
-
 		MissingResource *missing_resource = nullptr;
+		bool do_assign = false;
 
-		if (res.is_null()) { //not reuse
-			Ref<Resource> cache = ResourceCache::get_ref(path);
-			if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && cache.is_valid()) { //only if it doesn't exist
-				//cached, do not assign
-				res = cache;
-			} else {
-				//create
-
-				Object *obj = ClassDB::instantiate(type);
-				if (!obj) {
-					if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
-						missing_resource = memnew(MissingResource);
-						missing_resource->set_original_class(type);
-						missing_resource->set_recording_properties(true);
-						obj = missing_resource;
-					} else {
-						error_text += "Can't create sub resource of type: " + type;
-						_printerr();
-						error = ERR_FILE_CORRUPT;
-						return error;
-					}
-				}
-
-				Resource *r = Object::cast_to<Resource>(obj);
-				if (!r) {
-					error_text += "Can't create sub resource of type, because not a resource: " + type;
-					_printerr();
-					error = ERR_FILE_CORRUPT;
-					return error;
-				}
-
-				res = Ref<Resource>(r);
-				do_assign = true;
-			}
-		}
-
-		resource_current++;
-
-		if (progress && resources_total > 0) {
-			*progress = resource_current / float(resources_total);
-		}
-
-		int_resources[id] = res; // Always assign int resources.
-		if (do_assign) {
-			if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
-				res->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE);
-			} else {
-				res->set_path_cache(path);
-			}
-			res->set_scene_unique_id(id);
+		error = _create_sub_resource(next_tag, res, missing_resource, do_assign);
+		if (error) {
+			return error;
 		}
 
 		Dictionary missing_resource_properties;
@@ -605,35 +916,7 @@ Error ResourceLoaderText::load() {
 
 			if (!assign.is_empty()) {
 				if (do_assign) {
-					bool set_valid = true;
-
-					if (value.get_type() == Variant::OBJECT && missing_resource != nullptr) {
-						// If the property being set is a missing resource (and the parent is not),
-						// then setting it will most likely not work.
-						// Instead, save it as metadata.
-
-						Ref<MissingResource> mr = value;
-						if (mr.is_valid()) {
-							missing_resource_properties[assign] = mr;
-							set_valid = false;
-						}
-					}
-
-					if (value.get_type() == Variant::ARRAY) {
-						Array set_array = value;
-						bool is_get_valid = false;
-						Variant get_value = res->get(assign, &is_get_valid);
-						if (is_get_valid && get_value.get_type() == Variant::ARRAY) {
-							Array get_array = get_value;
-							if (!set_array.is_same_typed(get_array)) {
-								value = Array(set_array, get_array.get_typed_builtin(), get_array.get_typed_class_name(), get_array.get_typed_script());
-							}
-						}
-					}
-
-					if (set_valid) {
-						res->set(assign, value);
-					}
+					_set_resource_property(res, missing_resource, missing_resource_properties, assign, value);
 				}
 				//it's assignment
 			} else if (!next_tag.name.is_empty()) {
@@ -37,6 +37,8 @@
 #include "core/variant/variant_parser.h"
 #include "scene/resources/packed_scene.h"
 
+class MissingResource;
+
 class ResourceLoaderText {
 	bool translation_remapped = false;
 	String local_path;
@@ -83,8 +85,38 @@ class ResourceLoaderText {
 	static Error _parse_sub_resources(void *p_self, VariantParser::Stream *p_stream, Ref<Resource> &r_res, int &line, String &r_err_str) { return reinterpret_cast<ResourceLoaderText *>(p_self)->_parse_sub_resource(p_stream, r_res, line, r_err_str); }
 	static Error _parse_ext_resources(void *p_self, VariantParser::Stream *p_stream, Ref<Resource> &r_res, int &line, String &r_err_str) { return reinterpret_cast<ResourceLoaderText *>(p_self)->_parse_ext_resource(p_stream, r_res, line, r_err_str); }
 
+	static Error _parse_resolved_ext_resources(void *p_self, VariantParser::Stream *p_stream, Ref<Resource> &r_res, int &line, String &r_err_str) { return reinterpret_cast<ResourceLoaderText *>(p_self)->_parse_resolved_ext_resource(p_stream, r_res, line, r_err_str); }
+
 	Error _parse_sub_resource(VariantParser::Stream *p_stream, Ref<Resource> &r_res, int &line, String &r_err_str);
 	Error _parse_ext_resource(VariantParser::Stream *p_stream, Ref<Resource> &r_res, int &line, String &r_err_str);
+	Error _parse_resolved_ext_resource(VariantParser::Stream *p_stream, Ref<Resource> &r_res, int &line, String &r_err_str);
+	Error _get_ext_resource(const String &p_id, Ref<Resource> &r_res);
+
+	// Large files have their [sub_resource] bodies parsed in parallel, see _load_sub_resources_in_parallel().
+	enum {
+		PARALLEL_PARSE_MIN_SIZE = 1024 * 1024,
+	};
+
+	struct SubResourceSection {
+		VariantParser::Tag tag;
+		Ref<Resource> res;
+		MissingResource *missing_resource = nullptr;
+		bool do_assign = false;
+		uint64_t from = 0; // Body range in text_buffer.
+		uint64_t to = 0;
+		int line = 0;
+		LocalVector<Pair<String, Variant>> properties;
+		Error error = OK;
+		String error_text;
+	};
+
+	Vector<uint8_t> text_buffer;
+	HashMap<String, Ref<Resource>> resolved_ext_resources;
+
+	Error _create_sub_resource(const VariantParser::Tag &p_tag, Ref<Resource> &r_res, MissingResource *&r_missing_resource, bool &r_do_assign);
+	void _set_resource_property(const Ref<Resource> &p_res, MissingResource *p_missing_resource, Dictionary &r_missing_resource_properties, const String &p_name, Variant &p_value);
+	void _parse_sub_resource_section(uint32_t p_index, SubResourceSection *p_sections);
+	Error _load_sub_resources_in_parallel();
 
 	// for converter
 	class DummyResource : public Resource {
@@ -30,6 +30,8 @@
 
 #include "surface_tool.h"
 
+#include "core/object/worker_thread_pool.h"
+
 #define EQ_VERTEX_DIST 0.00001
 
 SurfaceTool::OptimizeVertexCacheFunc SurfaceTool::optimize_vertex_cache_func = nullptr;
@@ -134,17 +136,59 @@ bool SurfaceTool::Vertex::operator==(const Vertex &p_vertex) const {
 	return true;
 }
 
-uint32_t SurfaceTool::VertexHasher::hash(const Vertex &p_vtx) {
-	uint32_t h = hash_djb2_buffer((const uint8_t *)&p_vtx.vertex, sizeof(real_t) * 3);
-	h = hash_djb2_buffer((const uint8_t *)&p_vtx.normal, sizeof(real_t) * 3, h);
-	h = hash_djb2_buffer((const uint8_t *)&p_vtx.binormal, sizeof(real_t) * 3, h);
-	h = hash_djb2_buffer((const uint8_t *)&p_vtx.tangent, sizeof(real_t) * 3, h);
-	h = hash_djb2_buffer((const uint8_t *)&p_vtx.uv, sizeof(real_t) * 2, h);
-	h = hash_djb2_buffer((const uint8_t *)&p_vtx.uv2, sizeof(real_t) * 2, h);
-	h = hash_djb2_buffer((const uint8_t *)&p_vtx.color, sizeof(real_t) * 4, h);
-	h = hash_djb2_buffer((const uint8_t *)p_vtx.bones.ptr(), p_vtx.bones.size() * sizeof(int), h);
-	h = hash_djb2_buffer((const uint8_t *)p_vtx.weights.ptr(), p_vtx.weights.size() * sizeof(float), h);
-	h = hash_djb2_buffer((const uint8_t *)&p_vtx.custom[0], sizeof(Color) * RS::ARRAY_CUSTOM_COUNT, h);
+static _FORCE_INLINE_ uint32_t _hash_vector3(const Vector3 &p_vec, uint32_t p_seed) {
+	uint32_t h = hash_murmur3_one_real(p_vec.x, p_seed);
+	h = hash_murmur3_one_real(p_vec.y, h);
+	return hash_murmur3_one_real(p_vec.z, h);
+}
+
+static _FORCE_INLINE_ uint32_t _hash_vector2(const Vector2 &p_vec, uint32_t p_seed) {
+	uint32_t h = hash_murmur3_one_real(p_vec.x, p_seed);
+	return hash_murmur3_one_real(p_vec.y, h);
+}
+
+static _FORCE_INLINE_ uint32_t _hash_color(const Color &p_color, uint32_t p_seed) {
+	uint32_t h = hash_murmur3_one_float(p_color.r, p_seed);
+	h = hash_murmur3_one_float(p_color.g, h);
+	h = hash_murmur3_one_float(p_color.b, h);
+	return hash_murmur3_one_float(p_color.a, h);
+}
+
+uint32_t SurfaceTool::VertexHasher::hash(const Vertex &p_vtx, uint64_t p_format) {
+	// Attributes missing from the format are never committed, so they are left out of the hash.
+	// Equality still compares the whole vertex, this only saves hashing work.
+	uint32_t h = _hash_vector3(p_vtx.vertex, HASH_MURMUR3_SEED);
+	if (p_format & Mesh::ARRAY_FORMAT_NORMAL) {
+		h = _hash_vector3(p_vtx.normal, h);
+	}
+	if (p_format & Mesh::ARRAY_FORMAT_TANGENT) {
+		h = _hash_vector3(p_vtx.tangent, h);
+		h = _hash_vector3(p_vtx.binormal, h);
+	}
+	if (p_format & Mesh::ARRAY_FORMAT_TEX_UV) {
+		h = _hash_vector2(p_vtx.uv, h);
+	}
+	if (p_format & Mesh::ARRAY_FORMAT_TEX_UV2) {
+		h = _hash_vector2(p_vtx.uv2, h);
+	}
+	if (p_format & Mesh::ARRAY_FORMAT_COLOR) {
+		h = _hash_color(p_vtx.color, h);
+	}
+	if (p_format & Mesh::ARRAY_FORMAT_BONES) {
+		for (int i = 0; i < p_vtx.bones.size(); i++) {
+			h = hash_murmur3_one_32(p_vtx.bones[i], h);
+		}
+	}
+	if (p_format & Mesh::ARRAY_FORMAT_WEIGHTS) {
+		for (int i = 0; i < p_vtx.weights.size(); i++) {
+			h = hash_murmur3_one_float(p_vtx.weights[i], h);
+		}
+	}
+	for (int i = 0; i < RS::ARRAY_CUSTOM_COUNT; i++) {
+		if (p_format & custom_mask[i]) {
+			h = _hash_color(p_vtx.custom[i], h);
+		}
+	}
 	h = hash_murmur3_one_32(p_vtx.smooth_group, h);
 	h = hash_fmix32(h);
 	return h;
@@ -755,27 +799,74 @@ void SurfaceTool::index() {
 		return; //already indexed
 	}
 
-	HashMap<Vertex, int, VertexHasher> indices;
 	LocalVector<Vertex> old_vertex_array = vertex_array;
 	vertex_array.clear();
 
-	for (const Vertex &vertex : old_vertex_array) {
-		int *idxptr = indices.getptr(vertex);
+	uint32_t old_vertex_count = old_vertex_array.size();
+
+	// Hashes don't depend on each other, so compute them all upfront.
+	LocalVector<uint32_t> hashes;
+	hashes.resize(old_vertex_count);
+
+	IndexData index_data;
+	index_data.vertices = old_vertex_array.ptr();
+	index_data.vertex_count = old_vertex_count;
+	index_data.format = format;
+	index_data.hashes = hashes.ptr();
+
+	uint32_t chunk_count = (old_vertex_count + THREADED_CHUNK_SIZE - 1) / THREADED_CHUNK_SIZE;
+	if (chunk_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &SurfaceTool::_hash_vertices_threaded, &index_data, chunk_count, -1, true, SNAME("SurfaceToolHashVertices"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else if (chunk_count == 1) {
+		_hash_vertices_threaded(0, &index_data);
+	}
+
+	// Open addressing table of indices into the new vertex array, so vertices are never copied into keys.
+	uint32_t table_size = next_power_of_2(MAX(old_vertex_count * 2, 16u));
+	uint32_t table_mask = table_size - 1;
+	LocalVector<int> table;
+	table.resize(table_size);
+	for (uint32_t i = 0; i < table_size; i++) {
+		table[i] = -1;
+	}
+	LocalVector<uint32_t> unique_hashes;
+
+	index_array.resize(old_vertex_count);
+	for (uint32_t i = 0; i < old_vertex_count; i++) {
+		const Vertex &vertex = old_vertex_array[i];
+		uint32_t h = hashes[i];
+		uint32_t pos = h & table_mask;
 		int idx;
-		if (!idxptr) {
-			idx = indices.size();
-			vertex_array.push_back(vertex);
-			indices[vertex] = idx;
-		} else {
-			idx = *idxptr;
+		while (true) {
+			idx = table[pos];
+			if (idx == -1) {
+				idx = vertex_array.size();
+				table[pos] = idx;
+				vertex_array.push_back(vertex);
+				unique_hashes.push_back(h);
+				break;
+			}
+			if (unique_hashes[idx] == h && vertex_array[idx] == vertex) {
+				break;
+			}
+			pos = (pos + 1) & table_mask;
 		}
 
-		index_array.push_back(idx);
+		index_array[i] = idx;
 	}
 
 	format |= Mesh::ARRAY_FORMAT_INDEX;
 }
 
+void SurfaceTool::_hash_vertices_threaded(uint32_t p_chunk, IndexData *p_data) {
+	uint32_t from = p_chunk * THREADED_CHUNK_SIZE;
+	uint32_t to = MIN(from + THREADED_CHUNK_SIZE, p_data->vertex_count);
+	for (uint32_t i = from; i < to; i++) {
+		p_data->hashes[i] = VertexHasher::hash(p_data->vertices[i], p_data->format);
+	}
+}
+
 void SurfaceTool::deindex() {
 	if (index_array.size() == 0) {
 		return; //nothing to deindex
@@ -1182,6 +1273,32 @@ void SurfaceTool::generate_tangents() {
 	format |= Mesh::ARRAY_FORMAT_TANGENT;
 }
 
+void SurfaceTool::_generate_face_normals_threaded(uint32_t p_chunk, GenerateNormalsData *p_data) {
+	uint32_t from = p_chunk * THREADED_CHUNK_SIZE;
+	uint32_t to = MIN(from + THREADED_CHUNK_SIZE, p_data->vertex_count / 3);
+	for (uint32_t i = from; i < to; i++) {
+		const Vertex *v = &p_data->vertices[i * 3];
+		if (!p_data->flip) {
+			p_data->face_normals[i] = Plane(v[0].vertex, v[1].vertex, v[2].vertex).normal;
+		} else {
+			p_data->face_normals[i] = Plane(v[2].vertex, v[1].vertex, v[0].vertex).normal;
+		}
+	}
+}
+
+void SurfaceTool::_apply_normals_threaded(uint32_t p_chunk, GenerateNormalsData *p_data) {
+	uint32_t from = p_chunk * THREADED_CHUNK_SIZE;
+	uint32_t to = MIN(from + THREADED_CHUNK_SIZE, p_data->vertex_count);
+	for (uint32_t i = from; i < to; i++) {
+		Vertex &vertex = p_data->vertices[i];
+		if (vertex.smooth_group != UINT32_MAX) {
+			vertex.normal = p_data->smooth_normals[p_data->smooth_slots[i]].normalized();
+		} else {
+			vertex.normal = p_data->face_normals[i / 3];
+		}
+	}
+}
+
 void SurfaceTool::generate_normals(bool p_flip) {
 	ERR_FAIL_COND(primitive != Mesh::PRIMITIVE_TRIANGLES);
 
@@ -1191,42 +1308,60 @@ void SurfaceTool::generate_normals(bool p_flip) {
 
 	ERR_FAIL_COND((vertex_array.size() % 3) != 0);
 
-	HashMap<SmoothGroupVertex, Vector3, SmoothGroupVertexHasher> smooth_hash;
+	uint32_t vertex_count = vertex_array.size();
+	uint32_t face_count = vertex_count / 3;
 
-	for (uint32_t vi = 0; vi < vertex_array.size(); vi += 3) {
-		Vertex *v = &vertex_array[vi];
+	LocalVector<Vector3> face_normals;
+	face_normals.resize(face_count);
 
-		Vector3 normal;
-		if (!p_flip) {
-			normal = Plane(v[0].vertex, v[1].vertex, v[2].vertex).normal;
-		} else {
-			normal = Plane(v[2].vertex, v[1].vertex, v[0].vertex).normal;
+	GenerateNormalsData normals_data;
+	normals_data.vertices = vertex_array.ptr();
+	normals_data.vertex_count = vertex_count;
+	normals_data.flip = p_flip;
+	normals_data.face_normals = face_normals.ptr();
+
+	uint32_t face_chunk_count = (face_count + THREADED_CHUNK_SIZE - 1) / THREADED_CHUNK_SIZE;
+	if (face_chunk_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &SurfaceTool::_generate_face_normals_threaded, &normals_data, face_chunk_count, -1, true, SNAME("SurfaceToolFaceNormals"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else if (face_chunk_count == 1) {
+		_generate_face_normals_threaded(0, &normals_data);
+	}
+
+	// Add face normal to smooth vertex influence if vertex is member of a smoothing group.
+	// This is done in face order, so the sums don't depend on how the work above was split.
+	HashMap<SmoothGroupVertex, uint32_t, SmoothGroupVertexHasher> smooth_hash;
+	LocalVector<Vector3> smooth_normals;
+	LocalVector<uint32_t> smooth_slots;
+	smooth_slots.resize(vertex_count);
+
+	for (uint32_t vi = 0; vi < vertex_count; vi++) {
+		const Vertex &vertex = vertex_array[vi];
+		if (vertex.smooth_group == UINT32_MAX) {
+			continue;
 		}
 
-		for (int i = 0; i < 3; i++) {
-			// Add face normal to smooth vertex influence if vertex is member of a smoothing group
-			if (v[i].smooth_group != UINT32_MAX) {
-				Vector3 *lv = smooth_hash.getptr(v[i]);
-				if (!lv) {
-					smooth_hash.insert(v[i], normal);
-				} else {
-					(*lv) += normal;
-				}
-			} else {
-				v[i].normal = normal;
-			}
+		const Vector3 &normal = face_normals[vi / 3];
+		const uint32_t *slot = smooth_hash.getptr(vertex);
+		if (!slot) {
+			smooth_slots[vi] = smooth_normals.size();
+			smooth_hash.insert(vertex, smooth_normals.size());
+			smooth_normals.push_back(normal);
+		} else {
+			smooth_slots[vi] = *slot;
+			smooth_normals[*slot] += normal;
 		}
 	}
 
-	for (Vertex &vertex : vertex_array) {
-		if (vertex.smooth_group != UINT32_MAX) {
-			Vector3 *lv = smooth_hash.getptr(vertex);
-			if (!lv) {
-				vertex.normal = Vector3();
-			} else {
-				vertex.normal = lv->normalized();
-			}
-		}
+	normals_data.smooth_slots = smooth_slots.ptr();
+	normals_data.smooth_normals = smooth_normals.ptr();
+
+	uint32_t vertex_chunk_count = (vertex_count + THREADED_CHUNK_SIZE - 1) / THREADED_CHUNK_SIZE;
+	if (vertex_chunk_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &SurfaceTool::_apply_normals_threaded, &normals_data, vertex_chunk_count, -1, true, SNAME("SurfaceToolApplyNormals"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else if (vertex_chunk_count == 1) {
+		_apply_normals_threaded(0, &normals_data);
 	}
 
 	format |= Mesh::ARRAY_FORMAT_NORMAL;
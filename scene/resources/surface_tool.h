@@ -102,7 +102,7 @@ public:
 
 private:
 	struct VertexHasher {
-		static _FORCE_INLINE_ uint32_t hash(const Vertex &p_vtx);
+		static _FORCE_INLINE_ uint32_t hash(const Vertex &p_vtx, uint64_t p_format);
 	};
 
 	struct SmoothGroupVertex {
@@ -133,6 +133,28 @@ private:
 		}
 	};
 
+	static constexpr uint32_t THREADED_CHUNK_SIZE = 4096;
+
+	struct IndexData {
+		const Vertex *vertices = nullptr;
+		uint32_t vertex_count = 0;
+		uint64_t format = 0;
+		uint32_t *hashes = nullptr;
+	};
+
+	struct GenerateNormalsData {
+		Vertex *vertices = nullptr;
+		uint32_t vertex_count = 0;
+		bool flip = false;
+		Vector3 *face_normals = nullptr;
+		const uint32_t *smooth_slots = nullptr;
+		const Vector3 *smooth_normals = nullptr;
+	};
+
+	void _hash_vertices_threaded(uint32_t p_chunk, IndexData *p_data);
+	void _generate_face_normals_threaded(uint32_t p_chunk, GenerateNormalsData *p_data);
+	void _apply_normals_threaded(uint32_t p_chunk, GenerateNormalsData *p_data);
+
 	bool begun = false;
 	bool first = false;
 	Mesh::PrimitiveType primitive = Mesh::PRIMITIVE_LINES;
@@ -36,26 +36,154 @@ MaterialStorage *MaterialStorage::singleton = nullptr;
 
 MaterialStorage::MaterialStorage() {
 	singleton = this;
-	ShaderCompiler::DefaultIdentifierActions actions;
-	dummy_compiler.initialize(actions);
 }
 
 MaterialStorage::~MaterialStorage() {
+	_collect_compile_tasks(true);
+
+	List<RID> shaders;
+	shader_owner.get_owned_list(&shaders);
+	for (const RID &E : shaders) {
+		memdelete(shader_owner.get_or_null(E)->compile_state);
+	}
+
+	for (ShaderCompiler *compiler : free_compilers) {
+		memdelete(compiler);
+	}
 	singleton = nullptr;
 }
 
+ShaderCompiler *MaterialStorage::_get_compiler() const {
+	MutexLock lock(compiler_mutex);
+
+	if (!free_compilers.is_empty()) {
+		ShaderCompiler *compiler = free_compilers[free_compilers.size() - 1];
+		free_compilers.resize(free_compilers.size() - 1);
+		return compiler;
+	}
+
+	ShaderCompiler *compiler = memnew(ShaderCompiler);
+	ShaderCompiler::DefaultIdentifierActions actions;
+	compiler->initialize(actions);
+	compiler->set_compile_cache(&compile_cache);
+	return compiler;
+}
+
+void MaterialStorage::_release_compiler(ShaderCompiler *p_compiler) const {
+	MutexLock lock(compiler_mutex);
+	free_compilers.push_back(p_compiler);
+}
+
+// Runs a compilation the caller claimed by setting compiling.
+void MaterialStorage::_compile_shader(ShaderCompileState *p_state) const {
+	ShaderCompiler *compiler = _get_compiler();
+
+	ShaderCompiler::IdentifierActions actions;
+	actions.uniforms = &p_state->uniforms;
+	ShaderCompiler::GeneratedCode gen_code;
+
+	Error err = compiler->compile(p_state->mode, p_state->code, &actions, "", gen_code);
+	_release_compiler(compiler);
+
+	{
+		MutexLock lock(shader_compile_mutex);
+		p_state->compiling = false;
+	}
+	shader_compiled.notify_all();
+
+	ERR_FAIL_COND_MSG(err != OK, "Shader compilation failed.");
+}
+
+void MaterialStorage::_compile_shader_task(ShaderCompileState *p_state) {
+	bool compile = false;
+	bool orphaned = false;
+	{
+		MutexLock lock(shader_compile_mutex);
+		p_state->queued_tasks--;
+		if (p_state->pending) {
+			p_state->pending = false;
+			p_state->compiling = true;
+			compile = true;
+		}
+		orphaned = p_state->freed && p_state->queued_tasks == 0;
+	}
+
+	if (compile) {
+		_compile_shader(p_state);
+	}
+	if (orphaned) {
+		memdelete(p_state);
+	}
+}
+
+void MaterialStorage::_wait_for_shader(ShaderCompileState *p_state) const {
+	bool compile = false;
+	{
+		MutexLock lock(shader_compile_mutex);
+		while (p_state->compiling) {
+			shader_compiled.wait(lock);
+		}
+		// Rather than waiting for a task that may not have started, or that this thread is not
+		// allowed to wait for (ERR_BUSY), compile here. The task then finds nothing to do.
+		if (p_state->pending) {
+			p_state->pending = false;
+			p_state->compiling = true;
+			compile = true;
+		}
+	}
+
+	if (compile) {
+		_compile_shader(p_state);
+	}
+}
+
+void MaterialStorage::_collect_compile_tasks(bool p_wait) {
+	LocalVector<WorkerThreadPool::TaskID> done;
+	{
+		MutexLock lock(shader_compile_mutex);
+		for (uint32_t i = 0; i < compile_tasks.size(); i++) {
+			if (p_wait || WorkerThreadPool::get_singleton()->is_task_completed(compile_tasks[i])) {
+				done.push_back(compile_tasks[i]);
+				compile_tasks.remove_at_unordered(i);
+				i--;
+			}
+		}
+	}
+
+	for (WorkerThreadPool::TaskID task : done) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(task);
+	}
+}
+
 RID MaterialStorage::shader_allocate() {
 	return shader_owner.allocate_rid();
 }
 
 void MaterialStorage::shader_initialize(RID p_rid) {
-	shader_owner.initialize_rid(p_rid, DummyShader());
+	DummyShader shader;
+	shader.compile_state = memnew(ShaderCompileState);
+	shader_owner.initialize_rid(p_rid, shader);
 }
 
 void MaterialStorage::shader_free(RID p_rid) {
 	DummyShader *shader = shader_owner.get_or_null(p_rid);
 	ERR_FAIL_NULL(shader);
 
+	ShaderCompileState *state = shader->compile_state;
+	bool orphaned = false;
+	{
+		MutexLock lock(shader_compile_mutex);
+		while (state->compiling) {
+			shader_compiled.wait(lock);
+		}
+		state->pending = false;
+		state->freed = true;
+		orphaned = state->queued_tasks > 0;
+	}
+
+	if (!orphaned) {
+		memdelete(state);
+	}
 	shader_owner.free(p_rid);
 }
 
@@ -83,22 +211,45 @@ void MaterialStorage::shader_set_code(RID p_shader, const String &p_code) {
 		new_mode = RS::SHADER_MAX;
 		ERR_FAIL_MSG("Shader type " + mode_string + " not supported in Dummy renderer.");
 	}
-	ShaderCompiler::IdentifierActions actions;
-	actions.uniforms = &shader->uniforms;
-	ShaderCompiler::GeneratedCode gen_code;
 
-	Error err = MaterialStorage::get_singleton()->dummy_compiler.compile(new_mode, p_code, &actions, "", gen_code);
-	ERR_FAIL_COND_MSG(err != OK, "Shader compilation failed.");
+	ShaderCompileState *state = shader->compile_state;
+	bool queue_task = false;
+	{
+		MutexLock lock(shader_compile_mutex);
+		while (state->compiling) {
+			shader_compiled.wait(lock);
+		}
+		state->uniforms.clear();
+		state->code = p_code;
+		state->mode = new_mode;
+		// A task still queued for older code will compile this code instead.
+		if (!state->pending) {
+			state->pending = true;
+			state->queued_tasks++;
+			queue_task = true;
+		}
+	}
+
+	if (queue_task) {
+		_collect_compile_tasks(false);
+
+		WorkerThreadPool::TaskID task = WorkerThreadPool::get_singleton()->add_template_task(this, &MaterialStorage::_compile_shader_task, state, false, SNAME("DummyShaderCompile"));
+		MutexLock lock(shader_compile_mutex);
+		compile_tasks.push_back(task);
+	}
 }
 
 void MaterialStorage::get_shader_parameter_list(RID p_shader, List<PropertyInfo> *p_param_list) const {
 	DummyShader *shader = shader_owner.get_or_null(p_shader);
 	ERR_FAIL_NULL(shader);
 
+	const ShaderCompileState *state = shader->compile_state;
+	_wait_for_shader(shader->compile_state);
+
 	SortArray<Pair<StringName, int>, ShaderLanguage::UniformOrderComparator> sorter;
 	LocalVector<Pair<StringName, int>> filtered_uniforms;
 
-	for (const KeyValue<StringName, ShaderLanguage::ShaderNode::Uniform> &E : shader->uniforms) {
+	for (const KeyValue<StringName, ShaderLanguage::ShaderNode::Uniform> &E : state->uniforms) {
 		if (E.value.scope != ShaderLanguage::ShaderNode::Uniform::SCOPE_LOCAL) {
 			continue;
 		}
@@ -114,7 +265,7 @@ void MaterialStorage::get_shader_parameter_list(RID p_shader, List<PropertyInfo>
 	String last_group;
 	for (int i = 0; i < uniform_count; i++) {
 		const StringName &uniform_name = filtered_uniforms[i].first;
-		const ShaderLanguage::ShaderNode::Uniform &uniform = shader->uniforms[uniform_name];
+		const ShaderLanguage::ShaderNode::Uniform &uniform = state->uniforms[uniform_name];
 
 		String group = uniform.group;
 		if (!uniform.subgroup.is_empty()) {
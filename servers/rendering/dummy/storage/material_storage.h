@@ -31,6 +31,9 @@
 #ifndef MATERIAL_STORAGE_DUMMY_H
 #define MATERIAL_STORAGE_DUMMY_H
 
+#include "core/object/worker_thread_pool.h"
+#include "core/os/condition_variable.h"
+#include "core/os/mutex.h"
 #include "servers/rendering/shader_compiler.h"
 #include "servers/rendering/shader_language.h"
 #include "servers/rendering/storage/material_storage.h"
@@ -42,13 +45,45 @@ class MaterialStorage : public RendererMaterialStorage {
 private:
 	static MaterialStorage *singleton;
 
-	struct DummyShader {
+	// Shaders are parsed in the WorkerThreadPool. A pending compilation is run by whoever claims it
+	// first: its task, or a thread that needs the uniforms. The flags are guarded by shader_compile_mutex,
+	// the rest is only touched by the thread that claimed the compilation, or once nothing is compiling.
+	// This lives apart from the shader so it can outlive it while tasks still refer to it.
+	// The RD and GLES3 storages still compile in shader_set_code(), their materials need the generated
+	// code right away to build shader versions and uniform buffers.
+	struct ShaderCompileState {
 		HashMap<StringName, ShaderLanguage::ShaderNode::Uniform> uniforms;
+		String code;
+		RS::ShaderMode mode = RS::SHADER_MAX;
+
+		bool pending = false;
+		bool compiling = false;
+		bool freed = false; // The last queued task deletes it.
+		uint32_t queued_tasks = 0;
+	};
+
+	struct DummyShader {
+		ShaderCompileState *compile_state = nullptr;
 	};
 
 	mutable RID_Owner<DummyShader> shader_owner;
 
-	ShaderCompiler dummy_compiler;
+	mutable BinaryMutex shader_compile_mutex;
+	ConditionVariable shader_compiled;
+	LocalVector<WorkerThreadPool::TaskID> compile_tasks; // Collected once done, the pool requires it.
+
+	// ShaderCompiler is not reentrant, so each compilation takes its own from the pool. They share
+	// their cache, so identical shaders are parsed once whichever compiler gets them.
+	mutable Mutex compiler_mutex;
+	mutable LocalVector<ShaderCompiler *> free_compilers;
+	mutable ShaderCompiler::CompileCache compile_cache;
+
+	ShaderCompiler *_get_compiler() const;
+	void _release_compiler(ShaderCompiler *p_compiler) const;
+	void _compile_shader(ShaderCompileState *p_state) const;
+	void _compile_shader_task(ShaderCompileState *p_state);
+	void _wait_for_shader(ShaderCompileState *p_state) const;
+	void _collect_compile_tasks(bool p_wait);
 
 public:
 	static MaterialStorage *get_singleton() { return singleton; }
@@ -41,9 +41,6 @@
 void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RenderingServer::CanvasItemTextureFilter p_default_filter, RenderingServer::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, uint32_t p_canvas_cull_mask, RenderingMethod::RenderInfo *r_render_info) {
 	RENDER_TIMESTAMP("Cull CanvasItem Tree");
 
-	memset(z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
-	memset(z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
-
 	for (int i = 0; i < p_child_item_count; i++) {
 		_cull_canvas_item(p_child_items[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, true, p_canvas_cull_mask, p_child_items[i].mirror, 1);
 	}
@@ -51,7 +48,7 @@ void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas
 	RendererCanvasRender::Item *list = nullptr;
 	RendererCanvasRender::Item *list_end = nullptr;
 
-	for (int i = 0; i < z_range; i++) {
+	for (int i = z_list_min_used; i <= z_list_max_used; i++) {
 		if (!z_list[i]) {
 			continue;
 		}
@@ -64,6 +61,15 @@ void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas
 		}
 	}
 
+	// Leave the buckets empty for the next tree, without clearing all of them.
+	if (z_list_max_used >= z_list_min_used) {
+		int used_count = z_list_max_used - z_list_min_used + 1;
+		memset(z_list + z_list_min_used, 0, used_count * sizeof(RendererCanvasRender::Item *));
+		memset(z_last_list + z_list_min_used, 0, used_count * sizeof(RendererCanvasRender::Item *));
+	}
+	z_list_min_used = z_range;
+	z_list_max_used = -1;
+
 	RENDER_TIMESTAMP("Render CanvasItems");
 
 	bool sdf_flag;
@@ -105,6 +111,27 @@ void _collect_ysort_children(RendererCanvasCull::Item *p_canvas_item, Transform2
 	}
 }
 
+// Restores the y-sort order of items sorted in a previous frame, returns false if too many of them moved.
+static bool _ysort_items_incremental(RendererCanvasCull::Item **p_items, int p_count, int p_max_shifts) {
+	RendererCanvasCull::ItemPtrSort compare;
+	int shifts = 0;
+	for (int i = 1; i < p_count; i++) {
+		RendererCanvasCull::Item *item = p_items[i];
+		int j = i;
+		while (j > 0 && compare(item, p_items[j - 1])) {
+			p_items[j] = p_items[j - 1];
+			j--;
+		}
+		p_items[j] = item;
+
+		shifts += i - j;
+		if (shifts > p_max_shifts) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void _mark_ysort_dirty(RendererCanvasCull::Item *ysort_owner, RID_Owner<RendererCanvasCull::Item, true> &canvas_item_owner) {
 	do {
 		ysort_owner->ysort_children_count = -1;
@@ -112,6 +139,165 @@ void _mark_ysort_dirty(RendererCanvasCull::Item *ysort_owner, RID_Owner<Renderer
 	} while (ysort_owner && ysort_owner->sort_y);
 }
 
+static _FORCE_INLINE_ RendererCanvasCull::Item *_get_child_item(RendererCanvasCull::Item *p_child) {
+	return p_child;
+}
+
+static _FORCE_INLINE_ RendererCanvasCull::Item *_get_child_item(const RendererCanvasCull::Canvas::ChildItem &p_child) {
+	return p_child.item;
+}
+
+bool RendererCanvasCull::_get_cull_index_bounds(const Item *p_item, Rect2 &r_bounds) const {
+	// Only leaves whose visited area depends on nothing but their own transform and rect can be skipped.
+	if (!p_item->child_items.is_empty() || p_item->sort_y || p_item->canvas_group || p_item->copy_back_buffer || p_item->vp_render) {
+		return false;
+	}
+	if (p_item->repeat_source || p_item->repeat_size != Point2() || p_item->mirror != Point2()) {
+		return false;
+	}
+	if (!p_item->custom_rect && (p_item->update_when_visible || p_item->skeleton.is_valid())) {
+		return false;
+	}
+	if (_interpolation_data.interpolation_enabled && p_item->interpolated && p_item->xform_prev != p_item->xform_curr) {
+		return false;
+	}
+
+	Rect2 rect = p_item->get_rect();
+	if (p_item->visibility_notifier && p_item->visibility_notifier->area.size != Vector2()) {
+		rect = rect.merge(p_item->visibility_notifier->area);
+	}
+
+	// Grown to account for transforms snapped to pixels.
+	r_bounds = p_item->xform_curr.xform(rect).grow(1.0);
+	return true;
+}
+
+void RendererCanvasCull::_cull_index_add_item(CullIndex *p_index, Item *p_item) {
+	p_item->cull_index = p_index;
+	p_item->mark_cull_index_dirty();
+}
+
+void RendererCanvasCull::_cull_index_remove_item(Item *p_item) {
+	if (!p_item->cull_index) {
+		return;
+	}
+
+	if (p_item->cull_index_id.is_valid()) {
+		p_item->cull_index->bvh.remove(p_item->cull_index_id);
+		p_item->cull_index_id = DynamicBVH::ID();
+	}
+	p_item->cull_index_dirty_element.remove_from_list();
+	p_item->cull_index_unindexed_element.remove_from_list();
+	p_item->cull_index = nullptr;
+}
+
+void RendererCanvasCull::_cull_index_update_item(CullIndex *p_index, Item *p_item, bool p_allow_bvh) {
+	Rect2 bounds;
+	if (p_allow_bvh && _get_cull_index_bounds(p_item, bounds)) {
+		AABB aabb(Vector3(bounds.position.x, bounds.position.y, 0), Vector3(bounds.size.x, bounds.size.y, 0));
+		if (p_item->cull_index_id.is_valid()) {
+			p_index->bvh.update(p_item->cull_index_id, aabb);
+		} else {
+			p_item->cull_index_id = p_index->bvh.insert(aabb, p_item);
+		}
+		p_item->cull_index_unindexed_element.remove_from_list();
+	} else {
+		if (p_item->cull_index_id.is_valid()) {
+			p_index->bvh.remove(p_item->cull_index_id);
+			p_item->cull_index_id = DynamicBVH::ID();
+		}
+		if (!p_item->cull_index_unindexed_element.in_list()) {
+			p_index->unindexed_items.add(&p_item->cull_index_unindexed_element);
+		}
+	}
+}
+
+template <typename T>
+void RendererCanvasCull::_update_children_cull_index(CullIndex *&r_index, const Vector<T> &p_children) {
+	int child_count = p_children.size();
+
+	if (!r_index) {
+		if (child_count < CULL_INDEX_MIN_CHILDREN) {
+			return;
+		}
+		r_index = memnew(CullIndex);
+		r_index->interpolation_enabled = _interpolation_data.interpolation_enabled;
+		for (int i = 0; i < child_count; i++) {
+			_cull_index_add_item(r_index, _get_child_item(p_children[i]));
+		}
+	} else if (child_count < CULL_INDEX_MIN_CHILDREN / 2) {
+		for (int i = 0; i < child_count; i++) {
+			_cull_index_remove_item(_get_child_item(p_children[i]));
+		}
+		memdelete(r_index);
+		r_index = nullptr;
+		return;
+	} else if (r_index->interpolation_enabled != _interpolation_data.interpolation_enabled) {
+		r_index->interpolation_enabled = _interpolation_data.interpolation_enabled;
+		for (int i = 0; i < child_count; i++) {
+			_get_child_item(p_children[i])->mark_cull_index_dirty();
+		}
+	}
+
+	uint64_t frame = RSG::rasterizer->get_frame_number();
+
+	// Children changing in consecutive frames are considered moving and are not kept in the BVH.
+	SelfList<Item> *E = r_index->dirty_items.first();
+	while (E) {
+		SelfList<Item> *N = E->next();
+		Item *item = E->self();
+		r_index->dirty_items.remove(E);
+
+		bool moving = frame - item->cull_index_changed_frame < CULL_INDEX_STATIC_FRAMES;
+		item->cull_index_changed_frame = frame;
+		_cull_index_update_item(r_index, item, !moving);
+
+		E = N;
+	}
+
+	E = r_index->unindexed_items.first();
+	while (E) {
+		SelfList<Item> *N = E->next();
+		Item *item = E->self();
+		if (frame - item->cull_index_changed_frame >= CULL_INDEX_STATIC_FRAMES) {
+			_cull_index_update_item(r_index, item, true);
+		}
+		E = N;
+	}
+}
+
+bool RendererCanvasCull::_cull_index_query(CullIndex *p_index, const Transform2D &p_xform, const Rect2 &p_clip_rect) {
+	// The culled rect is the bounding box of the transformed item rect, which only matches
+	// the bounding box of the transformed bounds when the parent is not rotated or skewed.
+	if (p_xform.columns[0].y != 0 || p_xform.columns[1].x != 0 || Math::is_zero_approx(p_xform.determinant())) {
+		return false;
+	}
+
+	struct QueryResult {
+		LocalVector<Item *> *items = nullptr;
+		_FORCE_INLINE_ bool operator()(void *p_data) {
+			items->push_back((Item *)p_data);
+			return false;
+		}
+	};
+
+	// Items are culled against the clip rect after being offset by its position.
+	Rect2 local_clip = p_xform.affine_inverse().xform(Rect2(Point2(), p_clip_rect.size).grow(1.0));
+
+	p_index->visible_items.clear();
+	QueryResult query;
+	query.items = &p_index->visible_items;
+	p_index->bvh.aabb_query(AABB(Vector3(local_clip.position.x, local_clip.position.y, 0), Vector3(local_clip.size.x, local_clip.size.y, 0)), query);
+
+	for (SelfList<Item> *E = p_index->unindexed_items.first(); E; E = E->next()) {
+		p_index->visible_items.push_back(E->self());
+	}
+
+	SortArray<Item *, ItemIndexSort> sorter;
+	sorter.sort(p_index->visible_items.ptr(), p_index->visible_items.size());
+	return true;
+}
+
 void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *ci, RendererCanvasCull::Item *p_canvas_clip, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, const Transform2D &p_transform, const Rect2 &p_clip_rect, Rect2 p_global_rect, const Color &p_modulate, int p_z, RendererCanvasCull::Item *p_material_owner, bool p_use_canvas_group, RendererCanvasRender::Item *r_canvas_group_from) {
 	if (ci->copy_back_buffer) {
 		ci->copy_back_buffer->screen_rect = p_transform.xform(ci->copy_back_buffer->rect).intersection(p_clip_rect);
@@ -203,6 +389,8 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 			} else {
 				r_z_list[zidx] = ci;
 				r_z_last_list[zidx] = ci;
+				z_list_min_used = MIN(z_list_min_used, zidx);
+				z_list_max_used = MAX(z_list_max_used, zidx);
 			}
 
 			ci->z_final = p_z;
@@ -327,6 +515,7 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 			if (ci->ysort_children_count == -1) {
 				ci->ysort_children_count = 0;
 				_collect_ysort_children(ci, Transform2D(), p_material_owner, Color(1, 1, 1, 1), nullptr, ci->ysort_children_count, p_z);
+				ci->ysort_items.clear();
 			}
 
 			child_item_count = ci->ysort_children_count + 1;
@@ -341,8 +530,17 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 			int i = 1;
 			_collect_ysort_children(ci, Transform2D(), p_material_owner, Color(1, 1, 1, 1), child_items, i, p_z);
 
-			SortArray<Item *, ItemPtrSort> sorter;
-			sorter.sort(child_items, child_item_count);
+			// Most items keep their place between frames, so start from the previous order when the set is unchanged.
+			if (ci->ysort_items.size() != (uint32_t)child_item_count) {
+				ci->ysort_items.resize(child_item_count);
+				memcpy(ci->ysort_items.ptr(), child_items, child_item_count * sizeof(Item *));
+				SortArray<Item *, ItemPtrSort> sorter;
+				sorter.sort(ci->ysort_items.ptr(), child_item_count);
+			} else if (!_ysort_items_incremental(ci->ysort_items.ptr(), child_item_count, child_item_count * YSORT_INCREMENTAL_MAX_SHIFTS)) {
+				SortArray<Item *, ItemPtrSort> sorter;
+				sorter.sort(ci->ysort_items.ptr(), child_item_count);
+			}
+			child_items = ci->ysort_items.ptr();
 
 			for (i = 0; i < child_item_count; i++) {
 				_cull_canvas_item(child_items[i], final_xform * child_items[i]->ysort_xform, p_clip_rect, modulate * child_items[i]->ysort_modulate, child_items[i]->ysort_parent_abs_z_index, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, (Item *)child_items[i]->material_owner, false, p_canvas_cull_mask, repeat_size, repeat_times);
@@ -365,6 +563,14 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 			canvas_group_from = r_z_last_list[zidx];
 		}
 
+		if (!repeat_size.x && !repeat_size.y) {
+			_update_children_cull_index(ci->children_cull_index, ci->child_items);
+			if (ci->children_cull_index && _cull_index_query(ci->children_cull_index, final_xform, p_clip_rect)) {
+				child_items = ci->children_cull_index->visible_items.ptr();
+				child_item_count = ci->children_cull_index->visible_items.size();
+			}
+		}
+
 		for (int i = 0; i < child_item_count; i++) {
 			if (!child_items[i]->behind && !use_canvas_group) {
 				continue;
@@ -395,6 +601,19 @@ void RendererCanvasCull::render_canvas(RID p_render_target, Canvas *p_canvas, co
 	int l = p_canvas->child_items.size();
 	Canvas::ChildItem *ci = p_canvas->child_items.ptrw();
 
+	LocalVector<Canvas::ChildItem> visible_child_items;
+	_update_children_cull_index(p_canvas->children_cull_index, p_canvas->child_items);
+	if (p_canvas->children_cull_index && _cull_index_query(p_canvas->children_cull_index, p_transform, p_clip_rect)) {
+		const LocalVector<Item *> &visible_items = p_canvas->children_cull_index->visible_items;
+		visible_child_items.resize(visible_items.size());
+		for (uint32_t i = 0; i < visible_items.size(); i++) {
+			visible_child_items[i].item = visible_items[i];
+			visible_child_items[i].mirror = visible_items[i]->mirror;
+		}
+		l = visible_child_items.size();
+		ci = visible_child_items.ptr();
+	}
+
 	_render_canvas_item_tree(p_render_target, ci, l, p_transform, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel, canvas_cull_mask, r_render_info);
 
 	RENDER_TIMESTAMP("< Render Canvas");
@@ -420,6 +639,8 @@ void RendererCanvasCull::canvas_set_item_mirroring(RID p_canvas, RID p_item, con
 	int idx = canvas->find_item(canvas_item);
 	ERR_FAIL_COND(idx == -1);
 	canvas->child_items.write[idx].mirror = p_mirroring;
+	canvas_item->mirror = p_mirroring;
+	canvas_item->mark_cull_index_dirty();
 }
 
 void RendererCanvasCull::canvas_set_item_repeat(RID p_item, const Point2 &p_repeat_size, int p_repeat_times) {
@@ -429,6 +650,7 @@ void RendererCanvasCull::canvas_set_item_repeat(RID p_item, const Point2 &p_repe
 	canvas_item->repeat_source = true;
 	canvas_item->repeat_size = p_repeat_size;
 	canvas_item->repeat_times = p_repeat_times;
+	canvas_item->mark_cull_index_dirty();
 }
 
 void RendererCanvasCull::canvas_set_modulate(RID p_canvas, const Color &p_color) {
@@ -461,12 +683,16 @@ void RendererCanvasCull::canvas_item_set_parent(RID p_item, RID p_parent) {
 	ERR_FAIL_NULL(canvas_item);
 
 	if (canvas_item->parent.is_valid()) {
+		_cull_index_remove_item(canvas_item);
+
 		if (canvas_owner.owns(canvas_item->parent)) {
 			Canvas *canvas = canvas_owner.get_or_null(canvas_item->parent);
 			canvas->erase_item(canvas_item);
+			canvas_item->mirror = Point2();
 		} else if (canvas_item_owner.owns(canvas_item->parent)) {
 			Item *item_owner = canvas_item_owner.get_or_null(canvas_item->parent);
 			item_owner->child_items.erase(canvas_item);
+			item_owner->mark_cull_index_dirty();
 
 			if (item_owner->sort_y) {
 				_mark_ysort_dirty(item_owner, canvas_item_owner);
@@ -483,10 +709,17 @@ void RendererCanvasCull::canvas_item_set_parent(RID p_item, RID p_parent) {
 			ci.item = canvas_item;
 			canvas->child_items.push_back(ci);
 			canvas->children_order_dirty = true;
+			if (canvas->children_cull_index) {
+				_cull_index_add_item(canvas->children_cull_index, canvas_item);
+			}
 		} else if (canvas_item_owner.owns(p_parent)) {
 			Item *item_owner = canvas_item_owner.get_or_null(p_parent);
 			item_owner->child_items.push_back(canvas_item);
 			item_owner->children_order_dirty = true;
+			item_owner->mark_cull_index_dirty();
+			if (item_owner->children_cull_index) {
+				_cull_index_add_item(item_owner->children_cull_index, canvas_item);
+			}
 
 			if (item_owner->sort_y) {
 				_mark_ysort_dirty(item_owner, canvas_item_owner);
@@ -530,6 +763,7 @@ void RendererCanvasCull::canvas_item_set_transform(RID p_item, const Transform2D
 	}
 
 	canvas_item->xform_curr = p_transform;
+	canvas_item->mark_cull_index_dirty();
 }
 
 void RendererCanvasCull::canvas_item_set_visibility_layer(RID p_item, uint32_t p_visibility_layer) {
@@ -566,6 +800,7 @@ void RendererCanvasCull::canvas_item_set_custom_rect(RID p_item, bool p_custom_r
 
 	canvas_item->custom_rect = p_custom_rect;
 	canvas_item->rect = p_rect;
+	canvas_item->mark_cull_index_dirty();
 }
 
 void RendererCanvasCull::canvas_item_set_modulate(RID p_item, const Color &p_color) {
@@ -594,6 +829,7 @@ void RendererCanvasCull::canvas_item_set_update_when_visible(RID p_item, bool p_
 	ERR_FAIL_NULL(canvas_item);
 
 	canvas_item->update_when_visible = p_update;
+	canvas_item->mark_cull_index_dirty();
 }
 
 void RendererCanvasCull::canvas_item_add_line(RID p_item, const Point2 &p_from, const Point2 &p_to, const Color &p_color, float p_width, bool p_antialiased) {
@@ -1499,6 +1735,7 @@ void RendererCanvasCull::canvas_item_set_sort_children_by_y(RID p_item, bool p_e
 	ERR_FAIL_NULL(canvas_item);
 
 	canvas_item->sort_y = p_enable;
+	canvas_item->mark_cull_index_dirty();
 
 	_mark_ysort_dirty(canvas_item, canvas_item_owner);
 }
@@ -1526,6 +1763,7 @@ void RendererCanvasCull::canvas_item_attach_skeleton(RID p_item, RID p_skeleton)
 		return;
 	}
 	canvas_item->skeleton = p_skeleton;
+	canvas_item->mark_cull_index_dirty();
 
 	Item::Command *c = canvas_item->commands;
 
@@ -1563,6 +1801,7 @@ void RendererCanvasCull::canvas_item_set_copy_to_backbuffer(RID p_item, bool p_e
 		canvas_item->copy_back_buffer->rect = p_rect;
 		canvas_item->copy_back_buffer->full = p_rect == Rect2();
 	}
+	canvas_item->mark_cull_index_dirty();
 }
 
 void RendererCanvasCull::canvas_item_clear(RID p_item) {
@@ -1628,6 +1867,7 @@ void RendererCanvasCull::canvas_item_set_visibility_notifier(RID p_item, bool p_
 			canvas_item->visibility_notifier = nullptr;
 		}
 	}
+	canvas_item->mark_cull_index_dirty();
 }
 
 void RendererCanvasCull::canvas_item_set_debug_redraw(bool p_enabled) {
@@ -1643,12 +1883,14 @@ void RendererCanvasCull::canvas_item_set_interpolated(RID p_item, bool p_interpo
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
 	canvas_item->interpolated = p_interpolated;
+	canvas_item->mark_cull_index_dirty();
 }
 
 void RendererCanvasCull::canvas_item_reset_physics_interpolation(RID p_item) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
 	canvas_item->xform_prev = canvas_item->xform_curr;
+	canvas_item->mark_cull_index_dirty();
 }
 
 // Useful especially for origin shifting.
@@ -1657,6 +1899,7 @@ void RendererCanvasCull::canvas_item_transform_physics_interpolation(RID p_item,
 	ERR_FAIL_NULL(canvas_item);
 	canvas_item->xform_prev = p_transform * canvas_item->xform_prev;
 	canvas_item->xform_curr = p_transform * canvas_item->xform_curr;
+	canvas_item->mark_cull_index_dirty();
 }
 
 void RendererCanvasCull::canvas_item_set_canvas_group_mode(RID p_item, RS::CanvasGroupMode p_mode, float p_clear_margin, bool p_fit_empty, float p_fit_margin, bool p_blur_mipmaps) {
@@ -1678,6 +1921,7 @@ void RendererCanvasCull::canvas_item_set_canvas_group_mode(RID p_item, RS::Canva
 		canvas_item->canvas_group->blur_mipmaps = p_blur_mipmaps;
 		canvas_item->canvas_group->clear_margin = p_clear_margin;
 	}
+	canvas_item->mark_cull_index_dirty();
 }
 
 RID RendererCanvasCull::canvas_light_allocate() {
@@ -2152,8 +2396,12 @@ bool RendererCanvasCull::free(RID p_rid) {
 		}
 
 		for (int i = 0; i < canvas->child_items.size(); i++) {
+			_cull_index_remove_item(canvas->child_items[i].item);
 			canvas->child_items[i].item->parent = RID();
 		}
+		if (canvas->children_cull_index) {
+			memdelete(canvas->children_cull_index);
+		}
 
 		for (RendererCanvasRender::Light *E : canvas->lights) {
 			E->canvas = RID();
@@ -2170,6 +2418,8 @@ bool RendererCanvasCull::free(RID p_rid) {
 		ERR_FAIL_NULL_V(canvas_item, true);
 		_interpolation_data.notify_free_canvas_item(p_rid, *canvas_item);
 
+		_cull_index_remove_item(canvas_item);
+
 		if (canvas_item->parent.is_valid()) {
 			if (canvas_owner.owns(canvas_item->parent)) {
 				Canvas *canvas = canvas_owner.get_or_null(canvas_item->parent);
@@ -2177,6 +2427,7 @@ bool RendererCanvasCull::free(RID p_rid) {
 			} else if (canvas_item_owner.owns(canvas_item->parent)) {
 				Item *item_owner = canvas_item_owner.get_or_null(canvas_item->parent);
 				item_owner->child_items.erase(canvas_item);
+				item_owner->mark_cull_index_dirty();
 
 				if (item_owner->sort_y) {
 					_mark_ysort_dirty(item_owner, canvas_item_owner);
@@ -2185,8 +2436,13 @@ bool RendererCanvasCull::free(RID p_rid) {
 		}
 
 		for (int i = 0; i < canvas_item->child_items.size(); i++) {
+			_cull_index_remove_item(canvas_item->child_items[i]);
 			canvas_item->child_items[i]->parent = RID();
 		}
+		if (canvas_item->children_cull_index) {
+			memdelete(canvas_item->children_cull_index);
+			canvas_item->children_cull_index = nullptr;
+		}
 
 		if (canvas_item->visibility_notifier != nullptr) {
 			visibility_notifier_allocator.free(canvas_item->visibility_notifier);
@@ -2360,6 +2616,8 @@ void RendererCanvasCull::InterpolationData::notify_free_canvas_light_occluder(RI
 RendererCanvasCull::RendererCanvasCull() {
 	z_list = (RendererCanvasRender::Item **)memalloc(z_range * sizeof(RendererCanvasRender::Item *));
 	z_last_list = (RendererCanvasRender::Item **)memalloc(z_range * sizeof(RendererCanvasRender::Item *));
+	memset(z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
+	memset(z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 
 	disable_scale = false;
 
@@ -31,12 +31,27 @@
 #ifndef RENDERER_CANVAS_CULL_H
 #define RENDERER_CANVAS_CULL_H
 
+#include "core/math/dynamic_bvh.h"
 #include "core/templates/paged_allocator.h"
 #include "renderer_compositor.h"
 #include "renderer_viewport.h"
 
 class RendererCanvasCull {
 public:
+	struct Item;
+
+	// Spatial index over the children of a canvas or canvas item that has a lot of them.
+	// Leaf children that don't change are stored in a BVH by their bounds in the parent's
+	// space, so only those overlapping the viewport are visited when culling. Children that
+	// moved recently or can't be bounded are kept in a list and visited every frame.
+	struct CullIndex {
+		DynamicBVH bvh;
+		SelfList<Item>::List dirty_items;
+		SelfList<Item>::List unindexed_items;
+		LocalVector<Item *> visible_items;
+		bool interpolation_enabled = false;
+	};
+
 	struct Item : public RendererCanvasRender::Item {
 		RID parent; // canvas it belongs to
 		List<Item *>::Element *E;
@@ -57,6 +72,7 @@ public:
 		uint32_t visibility_layer = 0xffffffff;
 
 		Vector<Item *> child_items;
+		LocalVector<Item *> ysort_items; // Y-sorted order of the last frame, kept to sort incrementally.
 
 		struct VisibilityNotifierData {
 			Rect2 area;
@@ -72,7 +88,37 @@ public:
 
 		VisibilityNotifierData *visibility_notifier = nullptr;
 
-		Item() {
+		Point2 mirror; // Only used when the parent is a canvas.
+
+		CullIndex *cull_index = nullptr; // Index of the parent this item is registered in.
+		DynamicBVH::ID cull_index_id;
+		uint64_t cull_index_changed_frame = 0;
+		SelfList<Item> cull_index_dirty_element;
+		SelfList<Item> cull_index_unindexed_element;
+
+		CullIndex *children_cull_index = nullptr;
+
+		_FORCE_INLINE_ void mark_cull_index_dirty() {
+			if (cull_index && !cull_index_dirty_element.in_list()) {
+				cull_index->dirty_items.add(&cull_index_dirty_element);
+			}
+		}
+
+		// Changing the commands changes the rect, so the parent index must be updated.
+		template <typename T>
+		T *alloc_command() {
+			mark_cull_index_dirty();
+			return RendererCanvasRender::Item::alloc_command<T>();
+		}
+
+		void clear() {
+			mark_cull_index_dirty();
+			RendererCanvasRender::Item::clear();
+		}
+
+		Item() :
+				cull_index_dirty_element(this),
+				cull_index_unindexed_element(this) {
 			children_order_dirty = true;
 			E = nullptr;
 			z_index = 0;
@@ -144,6 +190,8 @@ public:
 		RID parent;
 		float parent_scale;
 
+		CullIndex *children_cull_index = nullptr;
+
 		int find_item(Item *p_item) {
 			for (int i = 0; i < child_items.size(); i++) {
 				if (child_items[i].item == p_item) {
@@ -192,8 +240,27 @@ private:
 
 	static constexpr int z_range = RS::CANVAS_ITEM_Z_MAX - RS::CANVAS_ITEM_Z_MIN + 1;
 
+	// Parents with fewer children than this are culled by visiting every child.
+	static constexpr int CULL_INDEX_MIN_CHILDREN = 256;
+	// Children must not change for this many frames before being stored in the BVH.
+	static constexpr uint64_t CULL_INDEX_STATIC_FRAMES = 8;
+
+	bool _get_cull_index_bounds(const Item *p_item, Rect2 &r_bounds) const;
+	void _cull_index_add_item(CullIndex *p_index, Item *p_item);
+	void _cull_index_remove_item(Item *p_item);
+	void _cull_index_update_item(CullIndex *p_index, Item *p_item, bool p_allow_bvh);
+	template <typename T>
+	void _update_children_cull_index(CullIndex *&r_index, const Vector<T> &p_children);
+	bool _cull_index_query(CullIndex *p_index, const Transform2D &p_xform, const Rect2 &p_clip_rect);
+
 	RendererCanvasRender::Item **z_list;
 	RendererCanvasRender::Item **z_last_list;
+	// Range of z_list used by the tree being culled, only this part is cleared afterwards.
+	int z_list_min_used = z_range;
+	int z_list_max_used = -1;
+
+	// When more shifts than this per item are needed to restore the y-sort order, sort from scratch.
+	static constexpr int YSORT_INCREMENTAL_MAX_SHIFTS = 16;
 
 public:
 	void render_canvas(RID p_render_target, Canvas *p_canvas, const Transform2D &p_transform, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, const Rect2 &p_clip_rect, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_transforms_to_pixel, bool p_snap_2d_vertices_to_pixel, uint32_t p_canvas_cull_mask, RenderingMethod::RenderInfo *r_render_info = nullptr);
@@ -33,6 +33,7 @@
 #include "core/config/project_settings.h"
 #include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
+#include "renderer_scene_occlusion_raster.h"
 #include "rendering_light_culler.h"
 #include "rendering_server_default.h"
 
@@ -874,6 +875,7 @@ void RendererSceneCull::instance_set_layer_mask(RID p_instance, uint32_t p_mask)
 	instance->layer_mask = p_mask;
 	if (instance->scenario && instance->array_index >= 0) {
 		instance->scenario->instance_data[instance->array_index].layer_mask = p_mask;
+		instance->scenario->update_bounds_block(instance->array_index);
 	}
 
 	if ((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK && instance->base_data) {
@@ -1097,6 +1099,7 @@ void RendererSceneCull::instance_set_ignore_culling(RID p_instance, bool p_enabl
 		} else {
 			idata.flags &= ~uint32_t(InstanceData::FLAG_IGNORE_ALL_CULLING);
 		}
+		instance->scenario->update_bounds_block(instance->array_index);
 	}
 }
 
@@ -1570,7 +1573,42 @@ void RendererSceneCull::instance_geometry_get_shader_parameter_list(RID p_instan
 	}
 }
 
-void RendererSceneCull::_update_instance(Instance *p_instance) {
+void RendererSceneCull::_update_instance_bounds(Instance *p_instance) {
+	p_instance->transformed_aabb = p_instance->transform.xform(p_instance->aabb);
+
+	//quantize to improve moving object performance
+	AABB bvh_aabb = p_instance->transformed_aabb;
+
+	if (p_instance->indexer_id.is_valid() && bvh_aabb != p_instance->prev_transformed_aabb) {
+		//assume motion, see if bounds need to be quantized
+		AABB motion_aabb = bvh_aabb.merge(p_instance->prev_transformed_aabb);
+		float motion_longest_axis = motion_aabb.get_longest_axis_size();
+		float longest_axis = p_instance->transformed_aabb.get_longest_axis_size();
+
+		if (motion_longest_axis < longest_axis * 2) {
+			//moved but not a lot, use motion aabb quantizing
+			float quantize_size = Math::pow(2.0, Math::ceil(Math::log(motion_longest_axis) / Math::log(2.0))) * 0.5; //one fifth
+			bvh_aabb.quantize(quantize_size);
+		}
+	}
+
+	p_instance->bvh_aabb = bvh_aabb;
+}
+
+void RendererSceneCull::_update_instance_bounds_threaded(uint32_t p_thread, LocalVector<Instance *> *p_instances) {
+	uint32_t total_threads = WorkerThreadPool::get_singleton()->get_thread_count();
+	uint32_t from = p_thread * p_instances->size() / total_threads;
+	uint32_t to = (p_thread + 1 == total_threads) ? p_instances->size() : ((p_thread + 1) * p_instances->size() / total_threads);
+
+	for (uint32_t i = from; i < to; i++) {
+		Instance *instance = (*p_instances)[i];
+		if (instance->aabb.has_surface()) {
+			_update_instance_bounds(instance);
+		}
+	}
+}
+
+void RendererSceneCull::_update_instance(Instance *p_instance, bool p_bounds_updated) {
 	p_instance->version++;
 
 	if (p_instance->base_type == RS::INSTANCE_LIGHT) {
@@ -1652,9 +1690,9 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		}
 	}
 
-	AABB new_aabb;
-	new_aabb = p_instance->transform.xform(p_instance->aabb);
-	p_instance->transformed_aabb = new_aabb;
+	if (!p_bounds_updated) {
+		_update_instance_bounds(p_instance);
+	}
 
 	if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
 		InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(p_instance->base_data);
@@ -1689,21 +1727,7 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		return;
 	}
 
-	//quantize to improve moving object performance
-	AABB bvh_aabb = p_instance->transformed_aabb;
-
-	if (p_instance->indexer_id.is_valid() && bvh_aabb != p_instance->prev_transformed_aabb) {
-		//assume motion, see if bounds need to be quantized
-		AABB motion_aabb = bvh_aabb.merge(p_instance->prev_transformed_aabb);
-		float motion_longest_axis = motion_aabb.get_longest_axis_size();
-		float longest_axis = p_instance->transformed_aabb.get_longest_axis_size();
-
-		if (motion_longest_axis < longest_axis * 2) {
-			//moved but not a lot, use motion aabb quantizing
-			float quantize_size = Math::pow(2.0, Math::ceil(Math::log(motion_longest_axis) / Math::log(2.0))) * 0.5; //one fifth
-			bvh_aabb.quantize(quantize_size);
-		}
-	}
+	const AABB &bvh_aabb = p_instance->bvh_aabb;
 
 	if (!p_instance->indexer_id.is_valid()) {
 		if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
@@ -1793,6 +1817,7 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 
 		p_instance->scenario->instance_data.push_back(idata);
 		p_instance->scenario->instance_aabbs.push_back(InstanceBounds(p_instance->transformed_aabb));
+		p_instance->scenario->update_bounds_block(p_instance->array_index);
 		_update_instance_visibility_dependencies(p_instance);
 	} else {
 		if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
@@ -1801,6 +1826,7 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 			p_instance->scenario->indexers[Scenario::INDEXER_VOLUMES].update(p_instance->indexer_id, bvh_aabb);
 		}
 		p_instance->scenario->instance_aabbs[p_instance->array_index] = InstanceBounds(p_instance->transformed_aabb);
+		p_instance->scenario->update_bounds_block(p_instance->array_index);
 	}
 
 	if (p_instance->visibility_index != -1) {
@@ -1888,6 +1914,7 @@ void RendererSceneCull::_unpair_instance(Instance *p_instance) {
 		swapped_instance->array_index = p_instance->array_index; //swap
 		p_instance->scenario->instance_data[p_instance->array_index] = p_instance->scenario->instance_data[swap_with_index];
 		p_instance->scenario->instance_aabbs[p_instance->array_index] = p_instance->scenario->instance_aabbs[swap_with_index];
+		p_instance->scenario->update_bounds_block(p_instance->array_index);
 
 		if (swapped_instance->visibility_index != -1) {
 			swapped_instance->scenario->instance_visibility[swapped_instance->visibility_index].array_index = swapped_instance->array_index;
@@ -1904,6 +1931,7 @@ void RendererSceneCull::_unpair_instance(Instance *p_instance) {
 	// pop last
 	p_instance->scenario->instance_data.pop_back();
 	p_instance->scenario->instance_aabbs.pop_back();
+	p_instance->scenario->update_bounds_block(p_instance->scenario->instance_data.size());
 
 	//uninitialize
 	p_instance->array_index = -1;
@@ -2307,14 +2335,12 @@ void RendererSceneCull::_light_instance_setup_directional_shadow(int p_shadow_in
 	}
 }
 
-bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario, float p_screen_mesh_lod_threshold, uint32_t p_visible_layers) {
+void RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario, float p_screen_mesh_lod_threshold, uint32_t p_visible_layers) {
 	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
 
 	Transform3D light_transform = p_instance->transform;
 	light_transform.orthonormalize(); //scale does not count on lights
 
-	bool animated_material_found = false;
-
 	switch (RSG::light_storage->light_get_type(p_instance->base)) {
 		case RS::LIGHT_DIRECTIONAL: {
 		} break;
@@ -2323,7 +2349,8 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 
 			if (shadow_mode == RS::LIGHT_OMNI_SHADOW_DUAL_PARABOLOID || !RSG::light_storage->light_instances_can_render_shadow_cube()) {
 				if (max_shadows_used + 2 > MAX_UPDATE_SHADOWS) {
-					return true;
+					light->make_shadow_dirty();
+					return;
 				}
 				for (int i = 0; i < 2; i++) {
 					//using this one ensures that raster deferred will have it
@@ -2341,48 +2368,7 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 					planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
 					planes.write[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
 
-					instance_shadow_cull_result.clear();
-
-					Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&planes[0], planes.size());
-
-					struct CullConvex {
-						PagedArray<Instance *> *result;
-						_FORCE_INLINE_ bool operator()(void *p_data) {
-							Instance *p_instance = (Instance *)p_data;
-							result->push_back(p_instance);
-							return false;
-						}
-					};
-
-					CullConvex cull_convex;
-					cull_convex.result = &instance_shadow_cull_result;
-
-					p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
-
-					RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
-
-					if (!light->is_shadow_update_full()) {
-						light_culler->cull_regular_light(instance_shadow_cull_result);
-					}
-
-					for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
-						Instance *instance = instance_shadow_cull_result[j];
-						if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !(p_visible_layers & instance->layer_mask)) {
-							continue;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
-
-							if (instance->mesh_instance.is_valid()) {
-								RSG::mesh_storage->mesh_instance_check_for_update(instance->mesh_instance);
-							}
-						}
-
-						shadow_data.instances.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
-					}
-
-					RSG::mesh_storage->update_mesh_instances();
+					RendererSceneRender::RenderShadowData &shadow_data = _add_shadow_cull_pass(p_instance, planes);
 
 					RSG::light_storage->light_instance_set_shadow_transform(light->instance, Projection(), light_transform, radius, 0, i, 0);
 					shadow_data.light = light->instance;
@@ -2391,7 +2377,8 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 			} else { //shadow cube
 
 				if (max_shadows_used + 6 > MAX_UPDATE_SHADOWS) {
-					return true;
+					light->make_shadow_dirty();
+					return;
 				}
 
 				real_t radius = RSG::light_storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
@@ -2423,47 +2410,8 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 
 					Vector<Plane> planes = cm.get_projection_planes(xform);
 
-					instance_shadow_cull_result.clear();
+					RendererSceneRender::RenderShadowData &shadow_data = _add_shadow_cull_pass(p_instance, planes);
 
-					Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&planes[0], planes.size());
-
-					struct CullConvex {
-						PagedArray<Instance *> *result;
-						_FORCE_INLINE_ bool operator()(void *p_data) {
-							Instance *p_instance = (Instance *)p_data;
-							result->push_back(p_instance);
-							return false;
-						}
-					};
-
-					CullConvex cull_convex;
-					cull_convex.result = &instance_shadow_cull_result;
-
-					p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
-
-					RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
-
-					if (!light->is_shadow_update_full()) {
-						light_culler->cull_regular_light(instance_shadow_cull_result);
-					}
-
-					for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
-						Instance *instance = instance_shadow_cull_result[j];
-						if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !(p_visible_layers & instance->layer_mask)) {
-							continue;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
-							if (instance->mesh_instance.is_valid()) {
-								RSG::mesh_storage->mesh_instance_check_for_update(instance->mesh_instance);
-							}
-						}
-
-						shadow_data.instances.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
-					}
-
-					RSG::mesh_storage->update_mesh_instances();
 					RSG::light_storage->light_instance_set_shadow_transform(light->instance, cm, xform, radius, 0, i, 0);
 
 					shadow_data.light = light->instance;
@@ -2479,7 +2427,8 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 			RENDER_TIMESTAMP("Cull SpotLight3D Shadow");
 
 			if (max_shadows_used + 1 > MAX_UPDATE_SHADOWS) {
-				return true;
+				light->make_shadow_dirty();
+				return;
 			}
 
 			real_t radius = RSG::light_storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
@@ -2490,56 +2439,103 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 
 			Vector<Plane> planes = cm.get_projection_planes(light_transform);
 
-			instance_shadow_cull_result.clear();
+			RendererSceneRender::RenderShadowData &shadow_data = _add_shadow_cull_pass(p_instance, planes);
+
+			RSG::light_storage->light_instance_set_shadow_transform(light->instance, cm, light_transform, radius, 0, 0, 0);
+			shadow_data.light = light->instance;
+			shadow_data.pass = 0;
+
+		} break;
+	}
+}
 
-			Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&planes[0], planes.size());
+RendererSceneRender::RenderShadowData &RendererSceneCull::_add_shadow_cull_pass(Instance *p_light, const Vector<Plane> &p_planes) {
+	ShadowCullPass &pass = shadow_cull_passes[shadow_cull_pass_count++];
+	pass.light = p_light;
+	pass.shadow_index = max_shadows_used++;
+	pass.tight_culling = !static_cast<InstanceLightData *>(p_light->base_data)->is_shadow_update_full();
+	pass.planes = p_planes;
+	return render_shadow_data[pass.shadow_index];
+}
 
-			struct CullConvex {
-				PagedArray<Instance *> *result;
-				_FORCE_INLINE_ bool operator()(void *p_data) {
-					Instance *p_instance = (Instance *)p_data;
-					result->push_back(p_instance);
-					return false;
-				}
-			};
+void RendererSceneCull::_shadow_cull_pass_threaded(uint32_t p_index, ShadowCullPass *p_passes) {
+	ShadowCullPass &pass = p_passes[p_index];
 
-			CullConvex cull_convex;
-			cull_convex.result = &instance_shadow_cull_result;
+	struct CullConvex {
+		PagedArray<Instance *> *result;
+		_FORCE_INLINE_ bool operator()(void *p_data) {
+			Instance *p_instance = (Instance *)p_data;
+			result->push_back(p_instance);
+			return false;
+		}
+	};
 
-			p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
+	CullConvex cull_convex;
+	cull_convex.result = &pass.instances;
 
-			RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
+	Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&pass.planes[0], pass.planes.size());
+	pass.light->scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(pass.planes.ptr(), pass.planes.size(), points.ptr(), points.size(), cull_convex);
+}
 
-			if (!light->is_shadow_update_full()) {
-				light_culler->cull_regular_light(instance_shadow_cull_result);
+void RendererSceneCull::_cull_shadow_passes(uint32_t p_visible_layers) {
+	if (shadow_cull_pass_count == 0) {
+		return;
+	}
+
+	RENDER_TIMESTAMP("Cull Light3D Shadows");
+
+	// Querying the indexer is independent for every pass, each one writes to its own result.
+	if (shadow_cull_pass_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererSceneCull::_shadow_cull_pass_threaded, shadow_cull_passes, shadow_cull_pass_count, -1, true, SNAME("CullLightShadows"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		_shadow_cull_pass_threaded(0, shadow_cull_passes);
+	}
+
+	// Results are applied in the order the passes were added, so the shadow data does not depend on scheduling.
+	Instance *prepared_light = nullptr;
+	for (uint32_t i = 0; i < shadow_cull_pass_count; i++) {
+		ShadowCullPass &pass = shadow_cull_passes[i];
+		InstanceLightData *light = static_cast<InstanceLightData *>(pass.light->base_data);
+
+		if (pass.tight_culling) {
+			// The light culler only keeps the planes of the last light prepared.
+			if (prepared_light != pass.light) {
+				light_culler->prepare_regular_light(*pass.light);
+				prepared_light = pass.light;
 			}
+			light_culler->cull_regular_light(pass.instances);
+		}
 
-			for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
-				Instance *instance = instance_shadow_cull_result[j];
-				if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !(p_visible_layers & instance->layer_mask)) {
-					continue;
-				} else {
-					if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-						animated_material_found = true;
-					}
+		RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[pass.shadow_index];
+		bool animated_material_found = false;
 
-					if (instance->mesh_instance.is_valid()) {
-						RSG::mesh_storage->mesh_instance_check_for_update(instance->mesh_instance);
-					}
+		for (int j = 0; j < (int)pass.instances.size(); j++) {
+			Instance *instance = pass.instances[j];
+			if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !(p_visible_layers & instance->layer_mask)) {
+				continue;
+			} else {
+				if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
+					animated_material_found = true;
 				}
-				shadow_data.instances.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
-			}
 
-			RSG::mesh_storage->update_mesh_instances();
+				if (instance->mesh_instance.is_valid()) {
+					RSG::mesh_storage->mesh_instance_check_for_update(instance->mesh_instance);
+				}
+			}
+			shadow_data.instances.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
+		}
 
-			RSG::light_storage->light_instance_set_shadow_transform(light->instance, cm, light_transform, radius, 0, 0, 0);
-			shadow_data.light = light->instance;
-			shadow_data.pass = 0;
+		if (animated_material_found) {
+			light->make_shadow_dirty();
+		}
 
-		} break;
+		pass.instances.clear();
 	}
 
-	return animated_material_found;
+	RSG::mesh_storage->update_mesh_instances();
+
+	shadow_cull_pass_count = 0;
 }
 
 void RendererSceneCull::render_camera(const Ref<RenderSceneBuffers> &p_render_buffers, RID p_camera, RID p_scenario, RID p_viewport, Size2 p_viewport_size, uint32_t p_jitter_phase_count, float p_screen_mesh_lod_threshold, RID p_shadow_atlas, Ref<XRInterface> &p_xr_interface, RenderInfo *r_render_info) {
@@ -2750,6 +2746,28 @@ void RendererSceneCull::_scene_cull_threaded(uint32_t p_thread, CullData *cull_d
 	_scene_cull(*cull_data, scene_cull_result_threads[p_thread], cull_from, cull_to);
 }
 
+void RendererSceneCull::_scene_cull_block(const CullData &cull_data, uint32_t p_block, uint32_t &r_camera_mask, uint32_t &r_any_mask) {
+	const InstanceBoundsBlock &block = cull_data.scenario->instance_bounds_blocks[p_block];
+
+	r_camera_mask = block.layer_check_mask(cull_data.visible_layers);
+	if (r_camera_mask) {
+		r_camera_mask &= block.in_frustum_mask(cull_data.cull->frustum);
+	}
+
+	// Instances outside of every view are skipped without touching their InstanceData.
+	r_any_mask = r_camera_mask | block.ignore_culling_mask;
+
+	for (uint32_t j = 0; j < cull_data.cull->shadow_count && r_any_mask != InstanceBoundsBlock::LANE_MASK; j++) {
+		for (uint32_t k = 0; k < cull_data.cull->shadows[j].cascade_count; k++) {
+			r_any_mask |= block.in_frustum_mask(cull_data.cull->shadows[j].cascades[k].frustum);
+		}
+	}
+
+	for (uint32_t j = 0; j < cull_data.cull->sdfgi.region_count && r_any_mask != InstanceBoundsBlock::LANE_MASK; j++) {
+		r_any_mask |= block.in_aabb_mask(cull_data.cull->sdfgi.region_aabb[j]);
+	}
+}
+
 void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cull_result, uint64_t p_from, uint64_t p_to) {
 	uint64_t frame_number = RSG::rasterizer->get_frame_number();
 	float lightmap_probe_update_speed = RSG::light_storage->lightmap_get_probe_capture_update_speed() * RSG::rasterizer->get_frame_delta_time();
@@ -2762,7 +2780,19 @@ void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cul
 	Transform3D inv_cam_transform = cull_data.cam_transform.inverse();
 	float z_near = cull_data.camera_matrix->get_z_near();
 
+	uint32_t camera_mask = 0;
+	uint32_t any_mask = 0;
+
 	for (uint64_t i = p_from; i < p_to; i++) {
+		uint32_t lane = i % InstanceBoundsBlock::SIZE;
+		if (lane == 0 || i == p_from) {
+			_scene_cull_block(cull_data, i / InstanceBoundsBlock::SIZE, camera_mask, any_mask);
+		}
+
+		if (!(any_mask & (1 << lane))) {
+			continue;
+		}
+
 		bool mesh_visible = false;
 
 		InstanceData &idata = cull_data.scenario->instance_data[i];
@@ -2778,7 +2808,7 @@ void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cul
 #define OCCLUSION_CULLED (cull_data.occlusion_buffer != nullptr && (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_OCCLUSION_CULLING) == 0 && cull_data.occlusion_buffer->is_occluded(cull_data.scenario->instance_aabbs[i].bounds, cull_data.cam_transform.origin, inv_cam_transform, *cull_data.camera_matrix, z_near))
 
 		if (!HIDDEN_BY_VISIBILITY_CHECKS) {
-			if ((LAYER_CHECK && IN_FRUSTUM(cull_data.cull->frustum) && VIS_CHECK && !OCCLUSION_CULLED) || (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_ALL_CULLING)) {
+			if (((camera_mask & (1 << lane)) && VIS_CHECK && !OCCLUSION_CULLED) || (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_ALL_CULLING)) {
 				uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
 				if (base_type == RS::INSTANCE_LIGHT) {
 					cull_result.lights.push_back(idata.instance);
@@ -3331,9 +3361,7 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 			if (redraw && max_shadows_used < MAX_UPDATE_SHADOWS) {
 				//must redraw!
 				RENDER_TIMESTAMP("> Render Light3D " + itos(i));
-				if (_light_instance_update_shadow(ins, p_camera_data->main_transform, p_camera_data->main_projection, p_camera_data->is_orthogonal, p_camera_data->vaspect, p_shadow_atlas, scenario, p_screen_mesh_lod_threshold, p_visible_layers)) {
-					light->make_shadow_dirty();
-				}
+				_light_instance_update_shadow(ins, p_camera_data->main_transform, p_camera_data->main_projection, p_camera_data->is_orthogonal, p_camera_data->vaspect, p_shadow_atlas, scenario, p_screen_mesh_lod_threshold, p_visible_layers);
 				RENDER_TIMESTAMP("< Render Light3D " + itos(i));
 			} else {
 				if (redraw) {
@@ -3341,6 +3369,8 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 				}
 			}
 		}
+
+		_cull_shadow_passes(p_visible_layers);
 	}
 
 	//render SDFGI
@@ -3874,7 +3904,7 @@ void RendererSceneCull::_update_instance_shader_uniforms_from_material(HashMap<S
 	}
 }
 
-void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
+void RendererSceneCull::_update_dirty_instance_data(Instance *p_instance) {
 	if (p_instance->update_aabb) {
 		_update_instance_aabb(p_instance);
 	}
@@ -4102,16 +4132,47 @@ void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
 
 	_instance_update_list.remove(&p_instance->update_item);
 
-	_update_instance(p_instance);
-
+	// Cleared before updating the instance, so updates queued again while updating other instances are not lost.
 	p_instance->update_aabb = false;
 	p_instance->update_dependencies = false;
 }
 
+void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
+	_update_dirty_instance_data(p_instance);
+	_update_instance(p_instance);
+}
+
 void RendererSceneCull::update_dirty_instances() {
 	while (_instance_update_list.first()) {
-		_update_dirty_instance(_instance_update_list.first()->self());
+		// Updating an instance may queue others (such as the geometry captured by a moved lightmap),
+		// those are handled in the next batch.
+		dirty_instances.clear();
+		for (SelfList<Instance> *E = _instance_update_list.first(); E; E = E->next()) {
+			dirty_instances.push_back(E->self());
+		}
+
+		if (dirty_instances.size() <= thread_cull_threshold) {
+			for (Instance *instance : dirty_instances) {
+				_update_dirty_instance(instance);
+			}
+			continue;
+		}
+
+		// Base AABBs and dependencies query the storages, so they are updated serially.
+		for (Instance *instance : dirty_instances) {
+			_update_dirty_instance_data(instance);
+		}
+
+		// Transformed bounds only depend on the instance itself.
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererSceneCull::_update_instance_bounds_threaded, &dirty_instances, WorkerThreadPool::get_singleton()->get_thread_count(), -1, true, SNAME("UpdateInstanceBounds"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+		// Indexer updates and pairing modify shared state, so they are applied serially.
+		for (Instance *instance : dirty_instances) {
+			_update_instance(instance, true);
+		}
 	}
+	dirty_instances.clear();
 
 	// Update dirty resources after dirty instances as instance updates may affect resources.
 	RSG::utilities->update_dirty_resources();
@@ -4153,6 +4214,7 @@ bool RendererSceneCull::free(RID p_rid) {
 		}
 		scenario->instance_aabbs.reset();
 		scenario->instance_data.reset();
+		scenario->instance_bounds_blocks.reset();
 		scenario->instance_visibility.reset();
 
 		RSG::light_storage->shadow_atlas_free(scenario->reflection_probe_shadow_atlas);
@@ -4234,7 +4296,9 @@ RendererSceneCull::RendererSceneCull() {
 	singleton = this;
 
 	instance_cull_result.set_page_pool(&instance_cull_page_pool);
-	instance_shadow_cull_result.set_page_pool(&instance_cull_page_pool);
+	for (uint32_t i = 0; i < MAX_UPDATE_SHADOWS; i++) {
+		shadow_cull_passes[i].instances.set_page_pool(&instance_cull_page_pool);
+	}
 
 	for (uint32_t i = 0; i < MAX_UPDATE_SHADOWS; i++) {
 		render_shadow_data[i].instances.set_page_pool(&geometry_instance_cull_page_pool);
@@ -4253,7 +4317,7 @@ RendererSceneCull::RendererSceneCull() {
 	thread_cull_threshold = GLOBAL_GET("rendering/limits/spatial_indexer/threaded_cull_minimum_instances");
 	thread_cull_threshold = MAX(thread_cull_threshold, (uint32_t)WorkerThreadPool::get_singleton()->get_thread_count()); //make sure there is at least one thread per CPU
 
-	dummy_occlusion_culling = memnew(RendererSceneOcclusionCull);
+	default_occlusion_culling = memnew(RendererSceneOcclusionRaster); // Replaced by modules providing a raytracing backend.
 
 	light_culler = memnew(RenderingLightCuller);
 
@@ -4264,10 +4328,10 @@ RendererSceneCull::RendererSceneCull() {
 
 RendererSceneCull::~RendererSceneCull() {
 	instance_cull_result.reset();
-	instance_shadow_cull_result.reset();
 
 	for (uint32_t i = 0; i < MAX_UPDATE_SHADOWS; i++) {
 		render_shadow_data[i].instances.reset();
+		shadow_cull_passes[i].instances.reset();
 	}
 	for (uint32_t i = 0; i < SDFGI_MAX_CASCADES * SDFGI_MAX_REGIONS_PER_CASCADE; i++) {
 		render_sdfgi_data[i].instances.reset();
@@ -4279,8 +4343,8 @@ RendererSceneCull::~RendererSceneCull() {
 	}
 	scene_cull_result_threads.clear();
 
-	if (dummy_occlusion_culling) {
-		memdelete(dummy_occlusion_culling);
+	if (default_occlusion_culling) {
+		memdelete(default_occlusion_culling);
 	}
 
 	if (light_culler) {
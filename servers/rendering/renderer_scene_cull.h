@@ -123,7 +123,7 @@ public:
 
 	/* VISIBILITY NOTIFIER API */
 
-	RendererSceneOcclusionCull *dummy_occlusion_culling = nullptr;
+	RendererSceneOcclusionCull *default_occlusion_culling = nullptr;
 
 	/* SCENARIO API */
 
@@ -248,6 +248,81 @@ public:
 		}
 	};
 
+	struct InstanceBoundsBlock {
+		// Bounds of consecutive instances stored per component, so the
+		// culling tests run over a whole block at once and get vectorized.
+		// Results are bit masks with one bit per instance in the block.
+
+		static const uint32_t SIZE = 8;
+		static const uint32_t LANE_MASK = (1 << SIZE) - 1;
+
+		real_t min_x[SIZE];
+		real_t min_y[SIZE];
+		real_t min_z[SIZE];
+		real_t max_x[SIZE];
+		real_t max_y[SIZE];
+		real_t max_z[SIZE];
+		uint32_t layer_mask[SIZE];
+		uint32_t ignore_culling_mask = 0;
+
+		_ALWAYS_INLINE_ void set(uint32_t p_lane, const InstanceBounds &p_bounds, uint32_t p_layer_mask, bool p_ignore_culling) {
+			min_x[p_lane] = p_bounds.bounds[0];
+			min_y[p_lane] = p_bounds.bounds[1];
+			min_z[p_lane] = p_bounds.bounds[2];
+			max_x[p_lane] = p_bounds.bounds[3];
+			max_y[p_lane] = p_bounds.bounds[4];
+			max_z[p_lane] = p_bounds.bounds[5];
+			layer_mask[p_lane] = p_layer_mask;
+			if (p_ignore_culling) {
+				ignore_culling_mask |= (1 << p_lane);
+			} else {
+				ignore_culling_mask &= ~(1 << p_lane);
+			}
+		}
+		_ALWAYS_INLINE_ uint32_t in_frustum_mask(const Frustum &p_frustum) const {
+			// Same test as InstanceBounds::in_frustum(). The corner picked for each plane
+			// only depends on the plane, so the inner loop is branchless.
+			uint32_t outside = 0;
+
+			for (uint32_t i = 0; i < p_frustum.plane_count; i++) {
+				const Plane &plane = p_frustum.planes_ptr[i];
+				const uint32_t *signs = p_frustum.plane_signs_ptr[i].signs;
+				const real_t *x = signs[0] == 0 ? min_x : max_x;
+				const real_t *y = signs[1] == 1 ? min_y : max_y;
+				const real_t *z = signs[2] == 2 ? min_z : max_z;
+
+				for (uint32_t j = 0; j < SIZE; j++) {
+					real_t d = plane.normal.x * x[j] + plane.normal.y * y[j] + plane.normal.z * z[j] - plane.d;
+					outside |= uint32_t(d >= 0.0) << j;
+				}
+			}
+
+			return ~outside & LANE_MASK;
+		}
+		_ALWAYS_INLINE_ uint32_t in_aabb_mask(const AABB &p_aabb) const {
+			Vector3 end = p_aabb.position + p_aabb.size;
+			uint32_t outside = 0;
+
+			for (uint32_t j = 0; j < SIZE; j++) {
+				uint32_t out = uint32_t(min_x[j] >= end.x) | uint32_t(max_x[j] <= p_aabb.position.x);
+				out |= uint32_t(min_y[j] >= end.y) | uint32_t(max_y[j] <= p_aabb.position.y);
+				out |= uint32_t(min_z[j] >= end.z) | uint32_t(max_z[j] <= p_aabb.position.z);
+				outside |= out << j;
+			}
+
+			return ~outside & LANE_MASK;
+		}
+		_ALWAYS_INLINE_ uint32_t layer_check_mask(uint32_t p_visible_layers) const {
+			uint32_t visible = 0;
+
+			for (uint32_t j = 0; j < SIZE; j++) {
+				visible |= uint32_t((layer_mask[j] & p_visible_layers) != 0) << j;
+			}
+
+			return visible;
+		}
+	};
+
 	struct InstanceVisibilityNotifierData;
 
 	struct InstanceData {
@@ -343,6 +418,22 @@ public:
 		PagedArray<InstanceData> instance_data;
 		VisibilityArray instance_visibility;
 
+		// Copy of instance_aabbs, layer masks and FLAG_IGNORE_ALL_CULLING used for block culling.
+		LocalVector<InstanceBoundsBlock> instance_bounds_blocks;
+
+		void update_bounds_block(uint32_t p_index) {
+			uint32_t block_count = (instance_data.size() + InstanceBoundsBlock::SIZE - 1) / InstanceBoundsBlock::SIZE;
+			if (instance_bounds_blocks.size() != block_count) {
+				instance_bounds_blocks.resize(block_count);
+			}
+			if (p_index >= instance_data.size()) {
+				return; // Removed.
+			}
+
+			const InstanceData &idata = instance_data[p_index];
+			instance_bounds_blocks[p_index / InstanceBoundsBlock::SIZE].set(p_index % InstanceBoundsBlock::SIZE, instance_aabbs[p_index], idata.layer_mask, idata.flags & InstanceData::FLAG_IGNORE_ALL_CULLING);
+		}
+
 		Scenario() {
 			indexers[INDEXER_GEOMETRY].set_index(INDEXER_GEOMETRY);
 			indexers[INDEXER_VOLUMES].set_index(INDEXER_VOLUMES);
@@ -428,6 +519,7 @@ public:
 		AABB aabb;
 		AABB transformed_aabb;
 		AABB prev_transformed_aabb;
+		AABB bvh_aabb; // Transformed AABB as stored in the indexer, quantized when moving.
 
 		struct InstanceShaderParameter {
 			int32_t index = -1;
@@ -872,7 +964,6 @@ public:
 	PagedArrayPool<RID> rid_cull_page_pool;
 
 	PagedArray<Instance *> instance_cull_result;
-	PagedArray<Instance *> instance_shadow_cull_result;
 
 	struct InstanceCullResult {
 		PagedArray<RenderGeometryInstance *> geometry_instances;
@@ -1000,11 +1091,25 @@ public:
 	RendererSceneRender::RenderShadowData render_shadow_data[MAX_UPDATE_SHADOWS];
 	uint32_t max_shadows_used = 0;
 
+	// Culling of a positional light shadow (one per cube face or paraboloid half), run in parallel once all are set up.
+	struct ShadowCullPass {
+		Instance *light = nullptr;
+		uint32_t shadow_index = 0;
+		bool tight_culling = false;
+		Vector<Plane> planes;
+		PagedArray<Instance *> instances;
+	};
+
+	ShadowCullPass shadow_cull_passes[MAX_UPDATE_SHADOWS];
+	uint32_t shadow_cull_pass_count = 0;
+
 	RendererSceneRender::RenderSDFGIData render_sdfgi_data[SDFGI_MAX_CASCADES * SDFGI_MAX_REGIONS_PER_CASCADE];
 	RendererSceneRender::RenderSDFGIUpdateData sdfgi_update_data;
 
 	uint32_t thread_cull_threshold = 200;
 
+	LocalVector<Instance *> dirty_instances;
+
 	RID_Owner<Instance, true> instance_owner;
 
 	uint32_t geometry_instance_pair_mask = 0; // used in traditional forward, unnecessary on clustered
@@ -1061,15 +1166,21 @@ public:
 	virtual Variant instance_geometry_get_shader_parameter(RID p_instance, const StringName &p_parameter) const;
 	virtual Variant instance_geometry_get_shader_parameter_default_value(RID p_instance, const StringName &p_parameter) const;
 
-	_FORCE_INLINE_ void _update_instance(Instance *p_instance);
+	_FORCE_INLINE_ void _update_instance(Instance *p_instance, bool p_bounds_updated = false);
+	_FORCE_INLINE_ void _update_instance_bounds(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_aabb(Instance *p_instance);
+	_FORCE_INLINE_ void _update_dirty_instance_data(Instance *p_instance);
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
+	void _update_instance_bounds_threaded(uint32_t p_thread, LocalVector<Instance *> *p_instances);
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 	void _unpair_instance(Instance *p_instance);
 
 	void _light_instance_setup_directional_shadow(int p_shadow_index, Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect);
 
-	_FORCE_INLINE_ bool _light_instance_update_shadow(Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario, float p_scren_mesh_lod_threshold, uint32_t p_visible_layers = 0xFFFFFF);
+	RendererSceneRender::RenderShadowData &_add_shadow_cull_pass(Instance *p_light, const Vector<Plane> &p_planes);
+	void _shadow_cull_pass_threaded(uint32_t p_index, ShadowCullPass *p_passes);
+	void _cull_shadow_passes(uint32_t p_visible_layers);
+	_FORCE_INLINE_ void _light_instance_update_shadow(Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario, float p_scren_mesh_lod_threshold, uint32_t p_visible_layers = 0xFFFFFF);
 
 	RID _render_get_environment(RID p_camera, RID p_scenario);
 	RID _render_get_compositor(RID p_camera, RID p_scenario);
@@ -1138,6 +1249,7 @@ public:
 	};
 
 	void _scene_cull_threaded(uint32_t p_thread, CullData *cull_data);
+	_FORCE_INLINE_ void _scene_cull_block(const CullData &cull_data, uint32_t p_block, uint32_t &r_camera_mask, uint32_t &r_any_mask);
 	void _scene_cull(CullData &cull_data, InstanceCullResult &cull_result, uint64_t p_from, uint64_t p_to);
 	_FORCE_INLINE_ bool _visibility_parent_check(const CullData &p_cull_data, const InstanceData &p_instance_data);
 
@@ -0,0 +1,389 @@
+/**************************************************************************/
+/*  renderer_scene_occlusion_raster.cpp                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "renderer_scene_occlusion_raster.h"
+
+#include "core/object/worker_thread_pool.h"
+
+void RendererSceneOcclusionRaster::RasterHZBuffer::clear() {
+	HZBuffer::clear();
+
+	view_vertices.clear();
+	triangles.clear();
+}
+
+void RendererSceneOcclusionRaster::RasterHZBuffer::begin(const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal) {
+	cam_inv_transform = p_cam_transform.affine_inverse();
+	cam_projection = p_cam_projection;
+	cam_planes = p_cam_projection.get_projection_planes(p_cam_transform);
+	p_cam_projection.get_endpoints(p_cam_transform, cam_points);
+	z_near = p_cam_projection.get_z_near();
+	cam_orthogonal = p_cam_orthogonal;
+
+	debug_tex_range = p_cam_projection.get_z_far();
+
+	triangles.clear();
+}
+
+void RendererSceneOcclusionRaster::RasterHZBuffer::add_occluder(const AABB &p_aabb, const Vector3 *p_vertices, uint32_t p_vertex_count, const uint32_t *p_indices, uint32_t p_index_count) {
+	if (!p_aabb.intersects_convex_shape(cam_planes.ptr(), cam_planes.size(), cam_points, 8)) {
+		return;
+	}
+
+	view_vertices.resize(p_vertex_count);
+	for (uint32_t i = 0; i < p_vertex_count; i++) {
+		view_vertices[i] = cam_inv_transform.xform(p_vertices[i]);
+	}
+
+	for (uint32_t i = 0; i + 2 < p_index_count; i += 3) {
+		uint32_t i0 = p_indices[i + 0];
+		uint32_t i1 = p_indices[i + 1];
+		uint32_t i2 = p_indices[i + 2];
+		if (i0 >= p_vertex_count || i1 >= p_vertex_count || i2 >= p_vertex_count) {
+			continue;
+		}
+
+		const Vector3 view[3] = { view_vertices[i0], view_vertices[i1], view_vertices[i2] };
+		_clip_triangle(view);
+	}
+}
+
+void RendererSceneOcclusionRaster::RasterHZBuffer::_clip_triangle(const Vector3 p_view[3]) {
+	// Clip against the near plane, so the depth of everything left is positive.
+	Vector3 clipped[4];
+	int clipped_count = 0;
+
+	for (int i = 0; i < 3; i++) {
+		const Vector3 &a = p_view[i];
+		const Vector3 &b = p_view[(i + 1) % 3];
+		float da = -a.z - z_near;
+		float db = -b.z - z_near;
+
+		if (da >= 0.0f) {
+			clipped[clipped_count++] = a;
+		}
+		if ((da >= 0.0f) != (db >= 0.0f)) {
+			clipped[clipped_count++] = a + (b - a) * (da / (da - db));
+		}
+	}
+
+	if (clipped_count < 3) {
+		return;
+	}
+
+	const Size2i &size = sizes[0];
+	Vector3 screen[4];
+
+	for (int i = 0; i < clipped_count; i++) {
+		Vector3 ndc = cam_projection.xform(clipped[i]);
+		float depth = -clipped[i].z;
+		// Depth is only linear in screen space for orthogonal projections, interpolate its inverse otherwise.
+		screen[i] = Vector3((ndc.x * 0.5f + 0.5f) * size.x, (ndc.y * 0.5f + 0.5f) * size.y, cam_orthogonal ? depth : 1.0f / MAX(depth, CMP_EPSILON));
+	}
+
+	_setup_triangle(screen);
+	if (clipped_count == 4) {
+		const Vector3 second[3] = { screen[0], screen[2], screen[3] };
+		_setup_triangle(second);
+	}
+}
+
+void RendererSceneOcclusionRaster::RasterHZBuffer::_setup_triangle(const Vector3 p_screen[3]) {
+	Vector3 v0 = p_screen[0];
+	Vector3 v1 = p_screen[1];
+	Vector3 v2 = p_screen[2];
+
+	float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+	if (Math::is_zero_approx(area)) {
+		return;
+	}
+
+	if (area < 0.0f) {
+		// Occluders are double sided.
+		SWAP(v1, v2);
+		area = -area;
+	}
+
+	const Size2i &size = sizes[0];
+
+	float min_x = MIN(v0.x, MIN(v1.x, v2.x));
+	float max_x = MAX(v0.x, MAX(v1.x, v2.x));
+	float min_y = MIN(v0.y, MIN(v1.y, v2.y));
+	float max_y = MAX(v0.y, MAX(v1.y, v2.y));
+
+	// Pixels are sampled at their center.
+	Triangle t;
+	t.min_x = Math::ceil(MAX(min_x - 0.5f, 0.0f));
+	t.max_x = Math::floor(MIN(max_x - 0.5f, float(size.x - 1)));
+	t.min_y = Math::ceil(MAX(min_y - 0.5f, 0.0f));
+	t.max_y = Math::floor(MIN(max_y - 0.5f, float(size.y - 1)));
+
+	if (t.min_x > t.max_x || t.min_y > t.max_y) {
+		return;
+	}
+
+	const Vector3 *edge_from[3] = { &v1, &v2, &v0 };
+	const Vector3 *edge_to[3] = { &v2, &v0, &v1 };
+	const float vertex_depth[3] = { v0.z, v1.z, v2.z };
+
+	t.depth[0] = 0.0f;
+	t.depth[1] = 0.0f;
+	t.depth[2] = 0.0f;
+
+	for (int i = 0; i < 3; i++) {
+		// Edge opposite to vertex i, normalized so it is the barycentric weight of that vertex.
+		const Vector3 &a = *edge_from[i];
+		const Vector3 &b = *edge_to[i];
+		t.edges[i][0] = (a.y - b.y) / area;
+		t.edges[i][1] = (b.x - a.x) / area;
+		t.edges[i][2] = ((b.y - a.y) * a.x - (b.x - a.x) * a.y) / area;
+
+		for (int j = 0; j < 3; j++) {
+			t.depth[j] += vertex_depth[i] * t.edges[i][j];
+		}
+	}
+
+	triangles.push_back(t);
+}
+
+void RendererSceneOcclusionRaster::RasterHZBuffer::_rasterize_band_threaded(uint32_t p_band, const RasterThreadData *p_data) {
+	const Size2i &size = sizes[0];
+	int from_y = p_band * size.y / p_data->band_count;
+	int to_y = (p_band + 1 == p_data->band_count) ? size.y : ((p_band + 1) * size.y / p_data->band_count);
+
+	float *depth_buffer = mips[0];
+	for (int i = from_y * size.x; i < to_y * size.x; i++) {
+		depth_buffer[i] = FLT_MAX;
+	}
+
+	for (const Triangle &t : triangles) {
+		int min_y = MAX(t.min_y, from_y);
+		int max_y = MIN(t.max_y, to_y - 1);
+
+		for (int y = min_y; y <= max_y; y++) {
+			float px = t.min_x + 0.5f;
+			float py = y + 0.5f;
+
+			float e0 = t.edges[0][0] * px + t.edges[0][1] * py + t.edges[0][2];
+			float e1 = t.edges[1][0] * px + t.edges[1][1] * py + t.edges[1][2];
+			float e2 = t.edges[2][0] * px + t.edges[2][1] * py + t.edges[2][2];
+			float z = t.depth[0] * px + t.depth[1] * py + t.depth[2];
+
+			float *row = &depth_buffer[y * size.x];
+
+			for (int x = t.min_x; x <= t.max_x; x++) {
+				if (e0 >= 0.0f && e1 >= 0.0f && e2 >= 0.0f) {
+					if (cam_orthogonal) {
+						row[x] = MIN(row[x], z);
+					} else if (z > 0.0f) {
+						row[x] = MIN(row[x], 1.0f / z);
+					}
+				}
+
+				e0 += t.edges[0][0];
+				e1 += t.edges[1][0];
+				e2 += t.edges[2][0];
+				z += t.depth[0];
+			}
+		}
+	}
+}
+
+void RendererSceneOcclusionRaster::RasterHZBuffer::rasterize() {
+	ERR_FAIL_COND(is_empty());
+
+	// Each thread owns a band of rows, so no synchronization is needed on the depth buffer.
+	RasterThreadData td;
+	td.band_count = MIN(WorkerThreadPool::get_singleton()->get_thread_count(), sizes[0].y);
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RasterHZBuffer::_rasterize_band_threaded, &td, td.band_count, -1, true, SNAME("OcclusionRasterize"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	update_mips();
+}
+
+////////////////////////////////////////////////////////
+
+bool RendererSceneOcclusionRaster::is_occluder(RID p_rid) {
+	return occluder_owner.owns(p_rid);
+}
+
+RID RendererSceneOcclusionRaster::occluder_allocate() {
+	return occluder_owner.allocate_rid();
+}
+
+void RendererSceneOcclusionRaster::occluder_initialize(RID p_occluder) {
+	Occluder *occluder = memnew(Occluder);
+	occluder_owner.initialize_rid(p_occluder, occluder);
+}
+
+void RendererSceneOcclusionRaster::occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) {
+	Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+	ERR_FAIL_NULL(occluder);
+
+	occluder->vertices = p_vertices;
+	occluder->indices = p_indices;
+	occluder->version++; // Instances using it will pick up the change on the next update.
+}
+
+void RendererSceneOcclusionRaster::free_occluder(RID p_occluder) {
+	Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+	ERR_FAIL_NULL(occluder);
+	memdelete(occluder);
+	occluder_owner.free(p_occluder);
+}
+
+////////////////////////////////////////////////////////
+
+void RendererSceneOcclusionRaster::add_scenario(RID p_scenario) {
+	ERR_FAIL_COND(scenarios.has(p_scenario));
+	scenarios[p_scenario] = Scenario();
+}
+
+void RendererSceneOcclusionRaster::remove_scenario(RID p_scenario) {
+	ERR_FAIL_COND(!scenarios.has(p_scenario));
+	scenarios.erase(p_scenario);
+}
+
+void RendererSceneOcclusionRaster::scenario_set_instance(RID p_scenario, RID p_instance, RID p_occluder, const Transform3D &p_xform, bool p_enabled) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_NULL(scenario);
+
+	OccluderInstance *instance = scenario->instances.getptr(p_instance);
+	if (!instance) {
+		instance = &scenario->instances.insert(p_instance, OccluderInstance())->value;
+	}
+
+	if (instance->occluder != p_occluder || instance->xform != p_xform) {
+		instance->occluder = p_occluder;
+		instance->xform = p_xform;
+		instance->dirty = true;
+	}
+
+	instance->enabled = p_enabled;
+}
+
+void RendererSceneOcclusionRaster::scenario_remove_instance(RID p_scenario, RID p_instance) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_NULL(scenario);
+	scenario->instances.erase(p_instance);
+}
+
+void RendererSceneOcclusionRaster::_update_instance(OccluderInstance &p_instance, const Occluder *p_occluder) {
+	int vertex_count = p_occluder->vertices.size();
+	const Vector3 *read = p_occluder->vertices.ptr();
+
+	p_instance.xformed_vertices.resize(vertex_count);
+	p_instance.aabb = AABB();
+
+	for (int i = 0; i < vertex_count; i++) {
+		Vector3 v = p_instance.xform.xform(read[i]);
+		p_instance.xformed_vertices[i] = v;
+		if (i == 0) {
+			p_instance.aabb.position = v;
+		} else {
+			p_instance.aabb.expand_to(v);
+		}
+	}
+
+	p_instance.indices.resize(p_occluder->indices.size());
+	if (!p_instance.indices.is_empty()) {
+		memcpy(p_instance.indices.ptr(), p_occluder->indices.ptr(), p_occluder->indices.size() * sizeof(int32_t));
+	}
+
+	p_instance.occluder_version = p_occluder->version;
+	p_instance.dirty = false;
+}
+
+////////////////////////////////////////////////////////
+
+void RendererSceneOcclusionRaster::add_buffer(RID p_buffer) {
+	ERR_FAIL_COND(buffers.has(p_buffer));
+	buffers[p_buffer] = RasterHZBuffer();
+}
+
+void RendererSceneOcclusionRaster::remove_buffer(RID p_buffer) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers.erase(p_buffer);
+}
+
+void RendererSceneOcclusionRaster::buffer_set_scenario(RID p_buffer, RID p_scenario) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	ERR_FAIL_COND(p_scenario.is_valid() && !scenarios.has(p_scenario));
+	buffers[p_buffer].scenario_rid = p_scenario;
+}
+
+void RendererSceneOcclusionRaster::buffer_set_size(RID p_buffer, const Vector2i &p_size) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers[p_buffer].resize(p_size);
+}
+
+void RendererSceneOcclusionRaster::buffer_update(RID p_buffer, const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal) {
+	RasterHZBuffer *buffer = buffers.getptr(p_buffer);
+	if (!buffer || buffer->is_empty()) {
+		return;
+	}
+
+	Scenario *scenario = scenarios.getptr(buffer->scenario_rid);
+	if (!scenario) {
+		return;
+	}
+
+	buffer->begin(p_cam_transform, p_cam_projection, p_cam_orthogonal);
+
+	for (KeyValue<RID, OccluderInstance> &E : scenario->instances) {
+		OccluderInstance &instance = E.value;
+		if (!instance.enabled) {
+			continue;
+		}
+
+		const Occluder *occluder = occluder_owner.get_or_null(instance.occluder);
+		if (!occluder) {
+			continue;
+		}
+
+		if (instance.dirty || instance.occluder_version != occluder->version) {
+			_update_instance(instance, occluder);
+		}
+
+		buffer->add_occluder(instance.aabb, instance.xformed_vertices.ptr(), instance.xformed_vertices.size(), instance.indices.ptr(), instance.indices.size());
+	}
+
+	buffer->rasterize();
+}
+
+RendererSceneOcclusionCull::HZBuffer *RendererSceneOcclusionRaster::buffer_get_ptr(RID p_buffer) {
+	return buffers.getptr(p_buffer);
+}
+
+RID RendererSceneOcclusionRaster::buffer_get_debug_texture(RID p_buffer) {
+	ERR_FAIL_COND_V(!buffers.has(p_buffer), RID());
+	return buffers[p_buffer].get_debug_texture();
+}
@@ -0,0 +1,135 @@
+/**************************************************************************/
+/*  renderer_scene_occlusion_raster.h                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef RENDERER_SCENE_OCCLUSION_RASTER_H
+#define RENDERER_SCENE_OCCLUSION_RASTER_H
+
+#include "core/math/projection.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/rid_owner.h"
+#include "servers/rendering/renderer_scene_occlusion_cull.h"
+
+// Occlusion culling backend that rasterizes the occluders into the depth buffer on the CPU,
+// used when no raytracing backend (Embree) is available or when explicitly requested.
+class RendererSceneOcclusionRaster : public RendererSceneOcclusionCull {
+public:
+	class RasterHZBuffer : public HZBuffer {
+	private:
+		struct Triangle {
+			// Edge functions (a * x + b * y + c), positive inside.
+			float edges[3][3];
+			// Plane of the interpolated depth attribute (1 / depth when using perspective).
+			float depth[3];
+			int min_x;
+			int max_x;
+			int min_y;
+			int max_y;
+		};
+
+		struct RasterThreadData {
+			uint32_t band_count;
+		};
+
+		Transform3D cam_inv_transform;
+		Projection cam_projection;
+		Vector<Plane> cam_planes;
+		Vector3 cam_points[8];
+		float z_near = 0.0f;
+		bool cam_orthogonal = false;
+
+		LocalVector<Vector3> view_vertices;
+		LocalVector<Triangle> triangles;
+
+		void _clip_triangle(const Vector3 p_view[3]);
+		void _setup_triangle(const Vector3 p_screen[3]);
+		void _rasterize_band_threaded(uint32_t p_band, const RasterThreadData *p_data);
+
+	public:
+		RID scenario_rid;
+
+		virtual void clear() override;
+
+		void begin(const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal);
+		void add_occluder(const AABB &p_aabb, const Vector3 *p_vertices, uint32_t p_vertex_count, const uint32_t *p_indices, uint32_t p_index_count);
+		void rasterize();
+	};
+
+private:
+	struct Occluder {
+		PackedVector3Array vertices;
+		PackedInt32Array indices;
+		uint64_t version = 1;
+	};
+
+	struct OccluderInstance {
+		RID occluder;
+		Transform3D xform;
+		bool enabled = true;
+		bool dirty = true;
+		uint64_t occluder_version = 0;
+		AABB aabb;
+		LocalVector<Vector3> xformed_vertices;
+		LocalVector<uint32_t> indices;
+	};
+
+	struct Scenario {
+		HashMap<RID, OccluderInstance> instances;
+	};
+
+	RID_PtrOwner<Occluder> occluder_owner;
+	HashMap<RID, Scenario> scenarios;
+	HashMap<RID, RasterHZBuffer> buffers;
+
+	void _update_instance(OccluderInstance &p_instance, const Occluder *p_occluder);
+
+public:
+	virtual bool is_occluder(RID p_rid) override;
+	virtual RID occluder_allocate() override;
+	virtual void occluder_initialize(RID p_occluder) override;
+	virtual void occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) override;
+	virtual void free_occluder(RID p_occluder) override;
+
+	virtual void add_scenario(RID p_scenario) override;
+	virtual void remove_scenario(RID p_scenario) override;
+	virtual void scenario_set_instance(RID p_scenario, RID p_instance, RID p_occluder, const Transform3D &p_xform, bool p_enabled) override;
+	virtual void scenario_remove_instance(RID p_scenario, RID p_instance) override;
+
+	virtual void add_buffer(RID p_buffer) override;
+	virtual void remove_buffer(RID p_buffer) override;
+	virtual HZBuffer *buffer_get_ptr(RID p_buffer) override;
+	virtual void buffer_set_scenario(RID p_buffer, RID p_scenario) override;
+	virtual void buffer_set_size(RID p_buffer, const Vector2i &p_size) override;
+	virtual void buffer_update(RID p_buffer, const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal) override;
+
+	virtual RID buffer_get_debug_texture(RID p_buffer) override;
+};
+
+#endif // RENDERER_SCENE_OCCLUSION_RASTER_H
@@ -30,6 +30,7 @@
 
 #include "shader_compiler.h"
 
+#include "core/config/engine.h"
 #include "core/config/project_settings.h"
 #include "core/os/os.h"
 #include "servers/rendering/rendering_server_globals.h"
@@ -1455,7 +1456,163 @@ ShaderLanguage::DataType ShaderCompiler::_get_global_shader_uniform_type(const S
 	return (ShaderLanguage::DataType)RS::global_shader_uniform_type_get_shader_datatype(gvt);
 }
 
+bool ShaderCompiler::_is_compile_cache_entry_valid(const CompileCacheEntry &p_entry) const {
+	if (!Engine::get_singleton()->is_editor_hint()) {
+		return true; // Global uniforms are only type checked in the editor.
+	}
+
+	for (const Pair<StringName, SL::DataType> &E : p_entry.global_uniforms) {
+		if (_get_global_shader_uniform_type(E.first) != E.second) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+Error ShaderCompiler::_replay_compile_cache_entry(const CompileCacheEntry &p_entry, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) const {
+	if (p_entry.error != OK) {
+		String file = p_entry.error_file.is_empty() ? p_path : p_entry.error_file;
+		_err_print_error(nullptr, file.utf8().get_data(), p_entry.error_line, p_entry.error_text.utf8().get_data(), false, ERR_HANDLER_SHADER);
+		return p_entry.error;
+	}
+
+	for (const StringName &E : p_entry.render_mode_flags) {
+		bool **flag = p_actions->render_mode_flags.getptr(E);
+		if (flag) {
+			**flag = true;
+		}
+	}
+
+	for (const Pair<StringName, int> &E : p_entry.render_mode_values) {
+		Pair<int *, int> *value = p_actions->render_mode_values.getptr(E.first);
+		if (value) {
+			*value->first = E.second;
+		}
+	}
+
+	for (const StringName &E : p_entry.usage_flags) {
+		bool **flag = p_actions->usage_flag_pointers.getptr(E);
+		if (flag) {
+			**flag = true;
+		}
+	}
+
+	for (const StringName &E : p_entry.write_flags) {
+		bool **flag = p_actions->write_flag_pointers.getptr(E);
+		if (flag) {
+			**flag = true;
+		}
+	}
+
+	for (const Pair<StringName, SL::ShaderNode::Uniform> &E : p_entry.uniforms) {
+		p_actions->uniforms->insert(E.first, E.second);
+	}
+
+	r_gen_code = p_entry.gen_code;
+
+	return OK;
+}
+
 Error ShaderCompiler::compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) {
+	CompileCacheKey key;
+	key.mode = p_mode;
+	key.code = p_code;
+
+	{
+		MutexLock lock(compile_cache->mutex);
+		const CompileCacheEntry *cached = compile_cache->entries.getptr(key);
+		if (cached && _is_compile_cache_entry_valid(*cached)) {
+			compile_cache->hits++;
+			return _replay_compile_cache_entry(*cached, p_actions, p_path, r_gen_code);
+		}
+
+		compile_cache->misses++;
+	}
+
+	// The actions point to state owned by the caller, snapshot it to find out what the compilation changed.
+	LocalVector<bool> render_mode_flags;
+	LocalVector<int> render_mode_values;
+	LocalVector<bool> usage_flags;
+	LocalVector<bool> write_flags;
+	for (const KeyValue<StringName, bool *> &E : p_actions->render_mode_flags) {
+		render_mode_flags.push_back(*E.value);
+	}
+	for (const KeyValue<StringName, Pair<int *, int>> &E : p_actions->render_mode_values) {
+		render_mode_values.push_back(*E.value.first);
+	}
+	for (const KeyValue<StringName, bool *> &E : p_actions->usage_flag_pointers) {
+		usage_flags.push_back(*E.value);
+	}
+	for (const KeyValue<StringName, bool *> &E : p_actions->write_flag_pointers) {
+		write_flags.push_back(*E.value);
+	}
+	uint32_t uniform_count = p_actions->uniforms->size();
+
+	CompileCacheEntry entry;
+	Error err = _compile(p_mode, p_code, p_actions, p_path, r_gen_code, entry);
+
+	if (err != OK) {
+		if (Engine::get_singleton()->is_editor_hint()) {
+			return err; // Errors may depend on global uniforms, which can change while editing.
+		}
+		entry.error = err;
+		MutexLock lock(compile_cache->mutex);
+		compile_cache->entries.insert(key, entry);
+		return err;
+	}
+
+	uint32_t idx = 0;
+	for (const KeyValue<StringName, bool *> &E : p_actions->render_mode_flags) {
+		if (*E.value && !render_mode_flags[idx]) {
+			entry.render_mode_flags.push_back(E.key);
+		}
+		idx++;
+	}
+	idx = 0;
+	for (const KeyValue<StringName, Pair<int *, int>> &E : p_actions->render_mode_values) {
+		if (*E.value.first != render_mode_values[idx]) {
+			entry.render_mode_values.push_back(Pair<StringName, int>(E.key, *E.value.first));
+		}
+		idx++;
+	}
+	idx = 0;
+	for (const KeyValue<StringName, bool *> &E : p_actions->usage_flag_pointers) {
+		if (*E.value && !usage_flags[idx]) {
+			entry.usage_flags.push_back(E.key);
+		}
+		idx++;
+	}
+	idx = 0;
+	for (const KeyValue<StringName, bool *> &E : p_actions->write_flag_pointers) {
+		if (*E.value && !write_flags[idx]) {
+			entry.write_flags.push_back(E.key);
+		}
+		idx++;
+	}
+	idx = 0;
+	for (const KeyValue<StringName, SL::ShaderNode::Uniform> &E : *p_actions->uniforms) {
+		// HashMap keeps insertion order, so the uniforms added by this compilation come last.
+		if (idx >= uniform_count) {
+			entry.uniforms.push_back(Pair<StringName, SL::ShaderNode::Uniform>(E.key, E.value));
+		}
+		idx++;
+	}
+
+	for (const KeyValue<StringName, SL::ShaderNode::Uniform> &E : parser.get_shader()->uniforms) {
+		if (E.value.scope == SL::ShaderNode::Uniform::SCOPE_GLOBAL) {
+			entry.global_uniforms.push_back(Pair<StringName, SL::DataType>(E.key, E.value.type));
+		}
+	}
+
+	entry.gen_code = r_gen_code;
+	MutexLock lock(compile_cache->mutex);
+	compile_cache->entries.insert(key, entry);
+
+	return OK;
+}
+
+Error ShaderCompiler::_compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code, CompileCacheEntry &r_cache_entry) {
 	SL::ShaderCompileInfo info;
 	info.functions = ShaderTypes::get_singleton()->get_functions(p_mode);
 	info.render_modes = ShaderTypes::get_singleton()->get_modes(p_mode);
@@ -1529,11 +1686,15 @@ Error ShaderCompiler::compile(RS::ShaderMode p_mode, const String &p_code, Ident
 		if (include_positions.size() > 1) {
 			file = include_positions[include_positions.size() - 1].file;
 			line = include_positions[include_positions.size() - 1].line;
+			r_cache_entry.error_file = file;
 		} else {
 			file = p_path;
 			line = parser.get_error_line();
 		}
 
+		r_cache_entry.error_line = line;
+		r_cache_entry.error_text = parser.get_error_text();
+
 		_err_print_error(nullptr, file.utf8().get_data(), line, parser.get_error_text().utf8().get_data(), false, ERR_HANDLER_SHADER);
 		return err;
 	}
@@ -1566,6 +1727,9 @@ Error ShaderCompiler::compile(RS::ShaderMode p_mode, const String &p_code, Ident
 void ShaderCompiler::initialize(DefaultIdentifierActions p_actions) {
 	actions = p_actions;
 
+	// The default actions shape the generated code, so earlier results no longer apply.
+	compile_cache->clear();
+
 	time_name = "TIME";
 
 	List<String> func_list;
@@ -1588,5 +1752,37 @@ void ShaderCompiler::initialize(DefaultIdentifierActions p_actions) {
 	texture_functions.insert("texelFetch");
 }
 
+void ShaderCompiler::set_compile_cache(CompileCache *p_cache) {
+	compile_cache = p_cache ? p_cache : &own_compile_cache;
+}
+
+uint64_t ShaderCompiler::get_compile_cache_hits() const {
+	MutexLock lock(compile_cache->mutex);
+	return compile_cache->hits;
+}
+
+uint64_t ShaderCompiler::get_compile_cache_misses() const {
+	MutexLock lock(compile_cache->mutex);
+	return compile_cache->misses;
+}
+
+void ShaderCompiler::CompileCache::clear() {
+	MutexLock lock(mutex);
+	entries.clear();
+}
+
+ShaderCompiler::CompileCache::CompileCache() :
+		entries(SIZE) {
+}
+
+ShaderCompiler::CompileCache::~CompileCache() {
+	if (hits > 0) {
+		print_verbose(vformat("ShaderCompiler: %d of %d shader compilations were served from the cache.", hits, hits + misses));
+	}
+}
+
 ShaderCompiler::ShaderCompiler() {
 }
+
+ShaderCompiler::~ShaderCompiler() {
+}
@@ -31,6 +31,8 @@
 #ifndef SHADER_COMPILER_H
 #define SHADER_COMPILER_H
 
+#include "core/os/mutex.h"
+#include "core/templates/lru.h"
 #include "core/templates/pair.h"
 #include "servers/rendering/shader_language.h"
 #include "servers/rendering_server.h"
@@ -44,6 +46,9 @@ public:
 		STAGE_MAX
 	};
 
+	// The pointers refer to state owned by the caller, which compile() only ever sets: flags
+	// become true, values and uniforms are written. Cached results are replayed as those same
+	// writes, so callers must reset their flags, values and uniforms before each compile().
 	struct IdentifierActions {
 		HashMap<StringName, Stage> entry_point_stages;
 
@@ -104,6 +109,63 @@ public:
 	};
 
 private:
+	// Results of previous compilations, so shaders with identical code (e.g. duplicated
+	// materials or visual shaders) are only parsed once. Besides the generated code, the
+	// entry stores the effects the compilation had on the IdentifierActions, to replay them.
+	struct CompileCacheKey {
+		RS::ShaderMode mode = RS::SHADER_MAX;
+		String code;
+
+		static uint32_t hash(const CompileCacheKey &p_key) {
+			return hash_murmur3_one_32(p_key.mode, p_key.code.hash());
+		}
+		bool operator==(const CompileCacheKey &p_key) const {
+			return mode == p_key.mode && code == p_key.code;
+		}
+	};
+
+	struct CompileCacheEntry {
+		Error error = OK;
+		String error_file; // Empty when the error is in the main shader, which is reported with the current path.
+		int error_line = 0;
+		String error_text;
+
+		GeneratedCode gen_code;
+		LocalVector<StringName> render_mode_flags;
+		LocalVector<Pair<StringName, int>> render_mode_values;
+		LocalVector<StringName> usage_flags;
+		LocalVector<StringName> write_flags;
+		LocalVector<Pair<StringName, ShaderLanguage::ShaderNode::Uniform>> uniforms;
+		LocalVector<Pair<StringName, ShaderLanguage::DataType>> global_uniforms; // Revalidated in the editor.
+	};
+
+public:
+	// Compilers initialized with the same default actions can share a cache, see set_compile_cache().
+	class CompileCache {
+		friend class ShaderCompiler;
+
+		static const int SIZE = 1024;
+
+		Mutex mutex;
+		LRUCache<CompileCacheKey, CompileCacheEntry, CompileCacheKey> entries;
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+
+	public:
+		void clear();
+
+		CompileCache();
+		~CompileCache();
+	};
+
+private:
+	CompileCache own_compile_cache;
+	CompileCache *compile_cache = &own_compile_cache;
+
+	bool _is_compile_cache_entry_valid(const CompileCacheEntry &p_entry) const;
+	Error _replay_compile_cache_entry(const CompileCacheEntry &p_entry, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) const;
+	Error _compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code, CompileCacheEntry &r_cache_entry);
+
 	ShaderLanguage parser;
 
 	String _get_sampler_name(ShaderLanguage::TextureFilter p_filter, ShaderLanguage::TextureRepeat p_repeat);
@@ -131,7 +193,17 @@ public:
 	Error compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code);
 
 	void initialize(DefaultIdentifierActions p_actions);
+
+	// Uses another compiler's cache instead of its own, e.g. for a pool of compilers used from several
+	// threads. Call after initialize(), the cache must outlive this compiler.
+	void set_compile_cache(CompileCache *p_cache);
+	CompileCache *get_compile_cache() { return compile_cache; }
+
+	uint64_t get_compile_cache_hits() const;
+	uint64_t get_compile_cache_misses() const;
+
 	ShaderCompiler();
+	~ShaderCompiler();
 };
 
 #endif // SHADER_COMPILER_H
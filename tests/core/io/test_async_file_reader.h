@@ -0,0 +1,94 @@
+/**************************************************************************/
+/*  test_async_file_reader.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_ASYNC_FILE_READER_H
+#define TEST_ASYNC_FILE_READER_H
+
+#include "core/io/async_file_reader.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAsyncFileReader {
+
+TEST_CASE("[AsyncFileReader] Read ranges") {
+	const String path = OS::get_singleton()->get_cache_path().path_join("async_file_reader.bin");
+	{
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		for (int i = 0; i < 10000; i++) {
+			f->store_8(i % 251);
+		}
+	}
+
+	AsyncFileReader *reader = AsyncFileReader::get_singleton();
+	REQUIRE(reader != nullptr);
+
+	SUBCASE("Adjacent and overlapping ranges") {
+		uint8_t buffers[8][500];
+		AsyncFileReader::RequestID ids[8];
+		for (int i = 0; i < 8; i++) {
+			// Out of order, some overlapping, so they get sorted and coalesced.
+			ids[i] = reader->read(path, ((7 - i) * 400) % 3000 + 17, buffers[i], 500);
+			CHECK(ids[i] != AsyncFileReader::INVALID_REQUEST_ID);
+		}
+		for (int i = 0; i < 8; i++) {
+			CHECK(reader->wait(ids[i]) == 500);
+			const int offset = ((7 - i) * 400) % 3000 + 17;
+			bool matches = true;
+			for (int j = 0; j < 500; j++) {
+				matches = matches && buffers[i][j] == (offset + j) % 251;
+			}
+			CHECK(matches);
+		}
+	}
+
+	SUBCASE("Reading past the end") {
+		uint8_t buffer[100];
+		AsyncFileReader::RequestID id = reader->read(path, 9950, buffer, 100);
+		CHECK(reader->wait(id) == 50);
+		CHECK(buffer[0] == 9950 % 251);
+		CHECK(buffer[49] == 9999 % 251);
+	}
+
+	SUBCASE("Missing file") {
+		uint8_t buffer[16];
+		AsyncFileReader::RequestID id = reader->read(path + ".missing", 0, buffer, 16);
+		CHECK(reader->wait(id) == -1);
+	}
+
+	DirAccess::remove_absolute(path);
+}
+
+} // namespace TestAsyncFileReader
+
+#endif // TEST_ASYNC_FILE_READER_H
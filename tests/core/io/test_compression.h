@@ -0,0 +1,131 @@
+/**************************************************************************/
+/*  test_compression.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_COMPRESSION_H
+#define TEST_COMPRESSION_H
+
+#include "core/io/compression.h"
+#include "core/io/file_access.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestCompression {
+
+static Vector<uint8_t> _make_data(int p_size) {
+	// Compressible, but not trivially so.
+	Vector<uint8_t> data;
+	data.resize(p_size);
+	uint32_t state = 12345;
+	for (int i = 0; i < p_size; i++) {
+		state = state * 1103515245 + 12345;
+		data.write[i] = (i % 7 == 0) ? uint8_t(state >> 24) : uint8_t(i / 64);
+	}
+	return data;
+}
+
+TEST_CASE("[Compression] Compress and decompress in blocks") {
+	const Compression::Mode modes[] = { Compression::MODE_FASTLZ, Compression::MODE_DEFLATE, Compression::MODE_ZSTD, Compression::MODE_GZIP };
+	// Large enough to be processed in parallel, and ending with a partial block.
+	const Vector<uint8_t> data = _make_data(1024 * 1024 + 1000);
+	const uint32_t block_size = 64 * 1024;
+
+	for (Compression::Mode mode : modes) {
+		Vector<uint8_t> compressed;
+		Vector<uint32_t> block_sizes;
+		REQUIRE(Compression::compress_blocks(compressed, block_sizes, data.ptr(), data.size(), block_size, mode) == OK);
+		CHECK(block_sizes.size() == 17);
+		CHECK(compressed.size() < data.size());
+
+		// Each block can be decompressed on its own.
+		Vector<uint8_t> block;
+		block.resize(block_size);
+		const uint64_t last_offset = compressed.size() - block_sizes[16];
+		CHECK(Compression::decompress(block.ptrw(), 1000, compressed.ptr() + last_offset, block_sizes[16], mode) == 1000);
+		CHECK(memcmp(block.ptr(), data.ptr() + 16 * block_size, 1000) == 0);
+
+		Vector<uint8_t> decompressed;
+		decompressed.resize(data.size());
+		CHECK(Compression::decompress_blocks(decompressed.ptrw(), decompressed.size(), compressed.ptr(), block_sizes.ptr(), block_sizes.size(), block_size, mode) == OK);
+		CHECK(decompressed == data);
+
+		if (mode == Compression::MODE_DEFLATE || mode == Compression::MODE_GZIP) {
+			// Corrupt data is reported, for the modes with a checksum to notice it.
+			compressed.write[compressed.size() / 2] ^= 0xff;
+			compressed.write[compressed.size() / 2 + 1] ^= 0xff;
+			ERR_PRINT_OFF;
+			CHECK(Compression::decompress_blocks(decompressed.ptrw(), decompressed.size(), compressed.ptr(), block_sizes.ptr(), block_sizes.size(), block_size, mode) != OK);
+			ERR_PRINT_ON;
+		}
+	}
+}
+
+TEST_CASE("[Compression] Compress nothing in blocks") {
+	Vector<uint8_t> compressed;
+	Vector<uint32_t> block_sizes;
+	CHECK(Compression::compress_blocks(compressed, block_sizes, nullptr, 0, 4096) == OK);
+	CHECK(compressed.is_empty());
+	CHECK(block_sizes.is_empty());
+}
+
+TEST_CASE("[Compression] Compressed file access") {
+	const String path = OS::get_singleton()->get_cache_path().path_join("compressed_file_access.bin");
+	const Vector<uint8_t> data = _make_data(512 * 1024);
+
+	const FileAccess::CompressionMode modes[] = { FileAccess::COMPRESSION_FASTLZ, FileAccess::COMPRESSION_DEFLATE, FileAccess::COMPRESSION_ZSTD, FileAccess::COMPRESSION_GZIP };
+	for (FileAccess::CompressionMode mode : modes) {
+		{
+			Ref<FileAccess> f = FileAccess::open_compressed(path, FileAccess::WRITE, mode);
+			REQUIRE(f.is_valid());
+			f->store_buffer(data);
+		}
+
+		Ref<FileAccess> f = FileAccess::open_compressed(path, FileAccess::READ, mode);
+		REQUIRE(f.is_valid());
+		CHECK(f->get_length() == (uint64_t)data.size());
+
+		// A read spanning many blocks, starting and ending within blocks.
+		f->seek(100);
+		Vector<uint8_t> middle = f->get_buffer(data.size() - 200);
+		REQUIRE(middle.size() == data.size() - 200);
+		CHECK(memcmp(middle.ptr(), data.ptr() + 100, middle.size()) == 0);
+		CHECK(f->get_position() == (uint64_t)data.size() - 100);
+		CHECK(f->get_8() == data[data.size() - 100]);
+
+		f->seek(0);
+		CHECK(f->get_buffer(data.size()) == data);
+		CHECK(!f->eof_reached());
+		CHECK(f->get_buffer(1).is_empty());
+		CHECK(f->eof_reached());
+	}
+}
+} // namespace TestCompression
+
+#endif // TEST_COMPRESSION_H
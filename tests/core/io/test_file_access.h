@@ -107,6 +107,28 @@ TEST_CASE("[FileAccess] Get as UTF-8 String") {
 	CHECK(s_cr == "Hello darkness\rMy old friend\rI've come to talk\rWith you again\r");
 	CHECK(s_cr_nocr == "Hello darknessMy old friendI've come to talkWith you again");
 }
+
+TEST_CASE("[FileAccess] Mapped data") {
+	Ref<FileAccess> f = FileAccess::open(TestUtils::get_data_path("testdata.csv"), FileAccess::READ);
+	REQUIRE(!f.is_null());
+
+	// Files are only mapped on request.
+	CHECK(f->get_mapped_data() == nullptr);
+	if (!f->map_data()) {
+		return; // Not supported by this platform's backend.
+	}
+	const uint8_t *mapped = f->get_mapped_data();
+	REQUIRE(mapped != nullptr);
+
+	// The mapping matches what regular reads return, and doesn't move the cursor.
+	Vector<uint8_t> data = f->get_buffer(f->get_length());
+	REQUIRE(data.size() == (int64_t)f->get_length());
+	CHECK(memcmp(mapped, data.ptr(), data.size()) == 0);
+	CHECK(f->get_mapped_data() == mapped);
+
+	f->seek(4);
+	CHECK(f->get_8() == mapped[4]);
+}
 } // namespace TestFileAccess
 
 #endif // TEST_FILE_ACCESS_H
@@ -326,6 +326,118 @@ TEST_CASE("[Marshalls] FLOAT double precision Variant decoding") {
 	CHECK(r_len == 12);
 	CHECK(variant == Variant(0.33333333333333333));
 }
+
+TEST_CASE("[Marshalls] Growable buffer Variant encoding") {
+	Dictionary inner;
+	inner["name"] = "inner";
+	inner[StringName("id")] = int64_t(0x123456789);
+	inner[2] = PackedStringArray({ "a", "", "ccc" });
+
+	Array array;
+	array.push_back(inner);
+	array.push_back(String::utf8("Godot ♥"));
+	array.push_back(PackedInt32Array({ 1, -2, 3 }));
+	array.push_back(PackedFloat64Array({ 0.5, 1.0 / 3.0 }));
+	array.push_back(Vector3(1, 2, 3));
+	array.push_back(Variant());
+
+	int expected_len;
+	REQUIRE(encode_variant(array, nullptr, expected_len) == OK);
+	Vector<uint8_t> expected;
+	expected.resize(expected_len);
+	REQUIRE(encode_variant(array, expected.ptrw(), expected_len) == OK);
+
+	// Appends after existing data and matches the fixed buffer encoder byte for byte.
+	Vector<uint8_t> buffer;
+	buffer.resize(4);
+	int len = 4;
+	CHECK(encode_variant(array, buffer, len) == OK);
+	REQUIRE(len == expected_len + 4);
+	CHECK(buffer.size() >= len);
+	CHECK(memcmp(buffer.ptr() + 4, expected.ptr(), expected_len) == 0);
+
+	Variant decoded;
+	int r_len;
+	CHECK(decode_variant(decoded, buffer.ptr() + 4, len - 4, &r_len) == OK);
+	CHECK(r_len == expected_len);
+	CHECK(decoded == Variant(array));
+}
+
+TEST_CASE("[Marshalls] Growable buffer Variant encoding size limit") {
+	Array array;
+	for (int i = 0; i < 64; i++) {
+		array.push_back(String("0123456789abcdef"));
+	}
+
+	int expected_len;
+	REQUIRE(encode_variant(array, nullptr, expected_len) == OK);
+
+	// The buffer is never grown past the limit, even though the encoding does not fit.
+	Vector<uint8_t> buffer;
+	int len = 0;
+	CHECK(encode_variant(array, buffer, len, false, 0, 256) == ERR_OUT_OF_MEMORY);
+	CHECK(buffer.size() <= 256);
+
+	buffer.clear();
+	len = 0;
+	CHECK(encode_variant(array, buffer, len, false, 0, expected_len) == OK);
+	CHECK(len == expected_len);
+	CHECK(buffer.size() == expected_len);
+}
+
+TEST_CASE("[Marshalls] Packed array Variant round trip") {
+	const Variant values[] = {
+		PackedByteArray({ 1, 2, 3, 4, 5 }),
+		PackedInt32Array({ 0, -1, 0x7fffffff }),
+		PackedInt64Array({ 0, -1, INT64_MAX }),
+		PackedFloat32Array({ 0.25f, -8.0f }),
+		PackedFloat64Array({ 0.1, -1e300 }),
+		PackedStringArray({ "one", "two" }),
+		PackedColorArray({ Color(1, 0, 0, 0.5) }),
+		PackedInt32Array(),
+	};
+
+	for (const Variant &value : values) {
+		Vector<uint8_t> buffer;
+		int len = 0;
+		REQUIRE(encode_variant(value, buffer, len) == OK);
+		CHECK(len % 4 == 0);
+
+		Variant decoded;
+		int r_len;
+		CHECK(decode_variant(decoded, buffer.ptr(), len, &r_len) == OK);
+		CHECK(r_len == len);
+		CHECK(decoded == value);
+	}
+}
+
+TEST_CASE("[Marshalls] Oversized array count Variant decoding") {
+	Variant variant;
+
+	SUBCASE("Array") {
+		uint8_t buffer[] = {
+			0x1c, 0x00, 0x00, 0x00, // Variant::ARRAY
+			0xff, 0xff, 0xff, 0x7f, // size, far more than the buffer holds
+			0x00, 0x00, 0x00, 0x00 // Variant::NIL
+		};
+
+		ERR_PRINT_OFF;
+		CHECK(decode_variant(variant, buffer, 12) == ERR_INVALID_DATA);
+		ERR_PRINT_ON;
+	}
+
+	SUBCASE("PackedStringArray") {
+		uint8_t buffer[] = {
+			0x22, 0x00, 0x00, 0x00, // Variant::PACKED_STRING_ARRAY
+			0xff, 0xff, 0xff, 0x7f, // size, far more than the buffer holds
+			0x00, 0x00, 0x00, 0x00 // empty string
+		};
+
+		ERR_PRINT_OFF;
+		CHECK(decode_variant(variant, buffer, 12) == ERR_INVALID_DATA);
+		ERR_PRINT_ON;
+	}
+}
 } // namespace TestMarshalls
 
 #endif // TEST_MARSHALLS_H
@@ -117,6 +117,70 @@ TEST_CASE("[PCKPacker] Pack a PCK file with some files and directories") {
 			f->get_length() <= 27000,
 			"The generated non-empty PCK file shouldn't be too large.");
 }
+
+TEST_CASE("[PCKPacker] Pack and read back compressed files") {
+	// Several blocks of compressible data, ending with a partial block.
+	const String source_path = OS::get_singleton()->get_cache_path().path_join("pck_packer_compressed_source.txt");
+	{
+		Ref<FileAccess> f = FileAccess::open(source_path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		for (int i = 0; i < 20000; i++) {
+			f->store_line(itos(i % 97) + " is a compressible line.");
+		}
+	}
+	const Vector<uint8_t> source = FileAccess::get_file_as_bytes(source_path);
+	REQUIRE(source.size() > PACK_COMPRESSED_BLOCK_SIZE * 2);
+
+	PCKPacker pck_packer;
+	const String output_pck_path = OS::get_singleton()->get_cache_path().path_join("output_compressed.pck");
+	REQUIRE(pck_packer.pck_start(output_pck_path) == OK);
+	CHECK(pck_packer.add_file_compressed("res://pck_packer_test/zstd.txt", source_path) == OK);
+	CHECK(pck_packer.add_file("res://pck_packer_test/plain.txt", source_path) == OK);
+	CHECK(pck_packer.add_file_compressed("res://pck_packer_test/fastlz.txt", source_path, FileAccess::COMPRESSION_FASTLZ) == OK);
+	ERR_PRINT_OFF;
+	CHECK_MESSAGE(
+			pck_packer.add_file_compressed("res://pck_packer_test/brotli.txt", source_path, FileAccess::COMPRESSION_BROTLI) != OK,
+			"Brotli can't be used to compress files.");
+	ERR_PRINT_ON;
+	REQUIRE(pck_packer.flush() == OK);
+
+	CHECK_MESSAGE(
+			FileAccess::get_file_as_bytes(output_pck_path).size() < source.size() * 2,
+			"The compressed files should take less space than the uncompressed one.");
+
+	// Read the pack through a temporary PackedData, so the global pack list is left untouched.
+	// No REQUIRE until it's deleted, so the global one is always restored.
+	PackedData *global_packed_data = PackedData::get_singleton();
+	PackedData *packed_data = memnew(PackedData);
+	CHECK(packed_data->add_pack(output_pck_path, true, 0) == OK);
+
+	const String paths[] = { "res://pck_packer_test/zstd.txt", "res://pck_packer_test/plain.txt", "res://pck_packer_test/fastlz.txt" };
+	for (const String &path : paths) {
+		Ref<FileAccess> f = packed_data->try_open_path(path);
+		CHECK_MESSAGE(f.is_valid(), path);
+		if (f.is_null()) {
+			continue;
+		}
+		CHECK(f->get_length() == (uint64_t)source.size());
+		CHECK(f->get_buffer(f->get_length()) == source);
+
+		// Random access, across a block boundary.
+		f->seek(PACK_COMPRESSED_BLOCK_SIZE - 2);
+		Vector<uint8_t> across = f->get_buffer(4);
+		CHECK(across.size() == 4);
+		CHECK(memcmp(across.ptr(), source.ptr() + PACK_COMPRESSED_BLOCK_SIZE - 2, MIN(across.size(), 4)) == 0);
+		f->seek(10);
+		CHECK(f->get_8() == source[10]);
+
+		f->seek_end();
+		CHECK(f->get_8() == 0);
+		CHECK(f->eof_reached());
+	}
+
+	memdelete(packed_data);
+	CHECK(PackedData::get_singleton() == global_packed_data);
+	CHECK_FALSE(global_packed_data && global_packed_data->has_path("res://pck_packer_test/plain.txt"));
+}
 } // namespace TestPCKPacker
 
 #endif // TEST_PCK_PACKER_H
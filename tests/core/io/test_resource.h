@@ -31,10 +31,14 @@
 #ifndef TEST_RESOURCE_H
 #define TEST_RESOURCE_H
 
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
 #include "core/io/resource.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
+#include "core/string/translation.h"
 
 #include "thirdparty/doctest/doctest.h"
 
@@ -110,6 +114,195 @@ TEST_CASE("[Resource] Saving and loading") {
 			"The loaded child resource name should be equal to the expected value.");
 }
 
+TEST_CASE("[Resource] Saving and loading packed arrays") {
+	// Odd sizes make sure the alignment padding before each payload is skipped correctly.
+	const Variant arrays[] = {
+		PackedByteArray({ 1, 2, 3 }),
+		PackedInt32Array({ 1, -2, 3 }),
+		PackedInt64Array({ INT64_MIN, 0, INT64_MAX }),
+		PackedFloat32Array({ 0.5f, -1.0f, 2.25f }),
+		PackedFloat64Array({ 0.1, -1e300, 3.0 }),
+		PackedStringArray({ "a", "bc" }),
+		PackedVector2Array({ Vector2(1, 2), Vector2(-3, 4) }),
+		PackedVector3Array({ Vector3(1, 2, 3), Vector3(-4, 5, -6), Vector3(7, 8, 9) }),
+		PackedColorArray({ Color(1, 0, 0.5, 1) }),
+		PackedVector3Array(),
+	};
+	const int array_count = sizeof(arrays) / sizeof(arrays[0]);
+
+	Ref<Resource> resource = memnew(Resource);
+	Ref<Resource> child_resource = memnew(Resource);
+	resource->set_meta("child", child_resource);
+	for (int i = 0; i < array_count; i++) {
+		resource->set_meta(vformat("array_%d", i), arrays[i]);
+		child_resource->set_meta(vformat("array_%d", i), arrays[i]);
+	}
+
+	const String save_path = OS::get_singleton()->get_cache_path().path_join("packed_arrays.res");
+	const String save_path_compressed = OS::get_singleton()->get_cache_path().path_join("packed_arrays_compressed.res");
+	REQUIRE(ResourceSaver::save(resource, save_path) == OK);
+	REQUIRE(ResourceSaver::save(resource, save_path_compressed, ResourceSaver::FLAG_COMPRESS) == OK);
+
+	for (const String &path : { save_path, save_path_compressed }) {
+		Ref<Resource> loaded = ResourceLoader::load(path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+		REQUIRE(loaded.is_valid());
+		Ref<Resource> loaded_child = loaded->get_meta("child");
+		REQUIRE(loaded_child.is_valid());
+		for (int i = 0; i < array_count; i++) {
+			CHECK_MESSAGE(loaded->get_meta(vformat("array_%d", i)) == arrays[i], "Packed array should survive a round trip.");
+			CHECK_MESSAGE(loaded_child->get_meta(vformat("array_%d", i)) == arrays[i], "Packed array in a sub-resource should survive a round trip.");
+		}
+	}
+}
+
+TEST_CASE("[Resource] Loading large text resources") {
+	// Large enough for the sub-resources to be parsed in parallel.
+	Ref<Resource> resource = memnew(Resource);
+	Array children;
+	for (int i = 0; i < 8; i++) {
+		Ref<Resource> child_resource = memnew(Resource);
+		child_resource->set_name(vformat("Child %d", i));
+		PackedFloat32Array values;
+		values.resize(20000);
+		for (int j = 0; j < values.size(); j++) {
+			values.set(j, i * 0.25f + j * 0.5f);
+		}
+		child_resource->set_meta("values", values);
+		if (i > 0) {
+			child_resource->set_meta("previous", children[i - 1]);
+		}
+		children.push_back(child_resource);
+	}
+	resource->set_meta("children", children);
+
+	const String save_path = OS::get_singleton()->get_cache_path().path_join("large_resource.tres");
+	REQUIRE(ResourceSaver::save(resource, save_path) == OK);
+
+	Ref<Resource> loaded = ResourceLoader::load(save_path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+	REQUIRE(loaded.is_valid());
+	Array loaded_children = loaded->get_meta("children");
+	REQUIRE(loaded_children.size() == children.size());
+	for (int i = 0; i < loaded_children.size(); i++) {
+		Ref<Resource> loaded_child = loaded_children[i];
+		Ref<Resource> child = children[i];
+		REQUIRE(loaded_child.is_valid());
+		CHECK(loaded_child->get_name() == child->get_name());
+		CHECK(loaded_child->get_meta("values") == child->get_meta("values"));
+		if (i > 0) {
+			CHECK_MESSAGE(loaded_child->get_meta("previous") == loaded_children[i - 1], "References between sub-resources should be preserved.");
+		}
+	}
+}
+
+TEST_CASE("[Resource] Loading external dependencies in parallel") {
+	const bool was_parallel = ResourceLoader::is_parallel_dependency_loading_enabled();
+	ResourceLoader::set_parallel_dependency_loading(true);
+
+	for (const String &extension : { "res", "tres" }) {
+		Ref<Resource> resource = memnew(Resource);
+		{
+			// The main resource refers to several resources saved in their own files.
+			for (int i = 0; i < 4; i++) {
+				Ref<Resource> dependency = memnew(Resource);
+				dependency->set_name(vformat("Dependency %d", i));
+				const String dependency_path = OS::get_singleton()->get_cache_path().path_join(vformat("dependency_%d.%s", i, extension));
+				ResourceSaver::save(dependency, dependency_path, ResourceSaver::FLAG_CHANGE_PATH);
+				resource->set_meta(vformat("dependency_%d", i), dependency);
+			}
+			// Referenced twice, but loaded once.
+			resource->set_meta("dependency_again", resource->get_meta("dependency_1"));
+		}
+		const String save_path = OS::get_singleton()->get_cache_path().path_join("resource_with_dependencies." + extension);
+		ResourceSaver::save(resource, save_path);
+		resource.unref(); // Frees the dependencies too, so they have to be loaded from disk.
+
+		const Ref<Resource> loaded_resource = ResourceLoader::load(save_path);
+		REQUIRE(loaded_resource.is_valid());
+		for (int i = 0; i < 4; i++) {
+			const Ref<Resource> loaded_dependency = loaded_resource->get_meta(vformat("dependency_%d", i));
+			REQUIRE(loaded_dependency.is_valid());
+			CHECK(loaded_dependency->get_name() == vformat("Dependency %d", i));
+		}
+		CHECK(loaded_resource->get_meta("dependency_again") == loaded_resource->get_meta("dependency_1"));
+	}
+
+	ResourceLoader::set_parallel_dependency_loading(was_parallel);
+}
+
+TEST_CASE("[Resource] Parallel dependency loading shares sub-dependencies") {
+	const bool was_parallel = ResourceLoader::is_parallel_dependency_loading_enabled();
+	ResourceLoader::set_parallel_dependency_loading(true);
+
+	for (const String &extension : { "res", "tres" }) {
+		const String cache_path = OS::get_singleton()->get_cache_path();
+		Ref<Resource> resource = memnew(Resource);
+		{
+			// Two dependencies refer to the same resource in its own file.
+			Ref<Resource> shared = memnew(Resource);
+			shared->set_name("Shared");
+			ResourceSaver::save(shared, cache_path.path_join("shared_dependency." + extension), ResourceSaver::FLAG_CHANGE_PATH);
+			for (int i = 0; i < 2; i++) {
+				Ref<Resource> dependency = memnew(Resource);
+				dependency->set_meta("shared", shared);
+				ResourceSaver::save(dependency, cache_path.path_join(vformat("sharing_dependency_%d.%s", i, extension)), ResourceSaver::FLAG_CHANGE_PATH);
+				resource->set_meta(vformat("dependency_%d", i), dependency);
+			}
+			// Dependencies without dependencies of their own.
+			for (int i = 0; i < 2; i++) {
+				Ref<Resource> leaf = memnew(Resource);
+				ResourceSaver::save(leaf, cache_path.path_join(vformat("leaf_dependency_%d.%s", i, extension)), ResourceSaver::FLAG_CHANGE_PATH);
+				resource->set_meta(vformat("leaf_%d", i), leaf);
+			}
+		}
+		const String save_path = cache_path.path_join("resource_with_shared_dependency." + extension);
+		ResourceSaver::save(resource, save_path);
+		resource.unref();
+
+		const Ref<Resource> loaded_resource = ResourceLoader::load(save_path);
+		REQUIRE(loaded_resource.is_valid());
+		const Ref<Resource> dependency_0 = loaded_resource->get_meta("dependency_0");
+		const Ref<Resource> dependency_1 = loaded_resource->get_meta("dependency_1");
+		REQUIRE(dependency_0.is_valid());
+		REQUIRE(dependency_1.is_valid());
+		const Ref<Resource> shared_0 = dependency_0->get_meta("shared");
+		const Ref<Resource> shared_1 = dependency_1->get_meta("shared");
+		REQUIRE(shared_0.is_valid());
+		CHECK(shared_0->get_name() == "Shared");
+		CHECK_MESSAGE(shared_0 == shared_1, "Both dependencies should get the same instance of the shared resource.");
+	}
+
+	ResourceLoader::set_parallel_dependency_loading(was_parallel);
+}
+
+TEST_CASE("[Resource] Choosing the thread for a dependency") {
+	const bool was_parallel = ResourceLoader::is_parallel_dependency_loading_enabled();
+	ResourceLoader::set_parallel_dependency_loading(true);
+
+	const String cache_path = OS::get_singleton()->get_cache_path();
+	const String imported_path = cache_path.path_join("imported_dependency.png");
+	const String not_imported_path = cache_path.path_join("not_imported_dependency.tres");
+	{
+		Ref<FileAccess> f = FileAccess::open(imported_path + ".import", FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_line("[remap]");
+	}
+
+	CHECK_MESSAGE(ResourceLoader::_get_dependency_thread_mode(imported_path, "Texture2D", false, false) == ResourceLoader::LOAD_THREAD_DISTRIBUTE,
+			"Imported resources other than scenes should be loaded on the worker pool.");
+	CHECK(ResourceLoader::_get_dependency_thread_mode(imported_path, "PackedScene", false, false) == ResourceLoader::LOAD_THREAD_FROM_CURRENT);
+	CHECK(ResourceLoader::_get_dependency_thread_mode(imported_path, "", false, false) == ResourceLoader::LOAD_THREAD_FROM_CURRENT);
+	CHECK_MESSAGE(ResourceLoader::_get_dependency_thread_mode(imported_path, "Texture2D", false, true) == ResourceLoader::LOAD_THREAD_FROM_CURRENT,
+			"The last dependency should be loaded by the thread that would otherwise wait for it.");
+	CHECK(ResourceLoader::_get_dependency_thread_mode(not_imported_path, "Resource", false, false) == ResourceLoader::LOAD_THREAD_FROM_CURRENT);
+	CHECK(ResourceLoader::_get_dependency_thread_mode(not_imported_path, "Resource", true, true) == ResourceLoader::LOAD_THREAD_DISTRIBUTE);
+
+	ResourceLoader::set_parallel_dependency_loading(false);
+	CHECK(ResourceLoader::_get_dependency_thread_mode(imported_path, "Texture2D", false, false) == ResourceLoader::LOAD_THREAD_FROM_CURRENT);
+
+	DirAccess::remove_absolute(imported_path + ".import");
+	ResourceLoader::set_parallel_dependency_loading(was_parallel);
+}
+
 TEST_CASE("[Resource] Breaking circular references on save") {
 	Ref<Resource> resource_a = memnew(Resource);
 	resource_a->set_name("A");
@@ -161,6 +354,90 @@ TEST_CASE("[Resource] Breaking circular references on save") {
 	// Break circular reference to avoid memory leak
 	resource_c->remove_meta("next");
 }
+
+TEST_CASE("[Resource] Retaining released resources in the cache") {
+	const String save_path = OS::get_singleton()->get_cache_path().path_join("resource_retained.tres");
+	{
+		Ref<Resource> resource = memnew(Resource);
+		resource->set_name("Retained");
+		ResourceSaver::save(resource, save_path);
+	}
+
+	const uint64_t budget_before = ResourceCache::get_retained_budget();
+	ResourceCache::set_retained_budget(1024 * 1024);
+
+	const uint64_t misses = ResourceCache::get_miss_count();
+	const uint64_t hits = ResourceCache::get_hit_count();
+	ObjectID loaded_id;
+	{
+		Ref<Resource> loaded = ResourceLoader::load(save_path);
+		REQUIRE(loaded.is_valid());
+		loaded_id = loaded->get_instance_id();
+	}
+	CHECK(ResourceCache::get_miss_count() == misses + 1);
+	CHECK_MESSAGE(ResourceCache::has(save_path), "The released resource should still be cached.");
+	CHECK(ResourceCache::get_retained_size() > 0);
+	CHECK(ResourceCache::get_retained_size_for_type("Resource") > 0);
+
+	{
+		Ref<Resource> loaded = ResourceLoader::load(save_path);
+		CHECK_MESSAGE(loaded->get_instance_id() == loaded_id, "The retained resource should be reused.");
+	}
+	CHECK(ResourceCache::get_hit_count() == hits + 1);
+	CHECK(ResourceCache::get_miss_count() == misses + 1);
+
+	const uint64_t evictions = ResourceCache::get_eviction_count();
+	ResourceCache::set_retained_budget(0);
+	CHECK(ResourceCache::get_eviction_count() == evictions + 1);
+	CHECK(ResourceCache::get_retained_size() == 0);
+	CHECK_MESSAGE(!ResourceCache::has(save_path), "The evicted resource should be freed.");
+
+	ResourceCache::set_retained_budget(budget_before);
+}
+
+static StringName retained_type_added;
+
+static void _retained_type_added(const StringName &p_type) {
+	retained_type_added = p_type;
+}
+
+static void _release_resource(void *p_resource) {
+	static_cast<Ref<Resource> *>(p_resource)->unref();
+}
+
+TEST_CASE("[Resource] Retaining a resource released on another thread") {
+	// A type no other test retains, so this is the first time it's added.
+	const String save_path = OS::get_singleton()->get_cache_path().path_join("resource_retained_threaded.tres");
+	{
+		Ref<Translation> translation = memnew(Translation);
+		translation->set_locale("fr");
+		ResourceSaver::save(translation, save_path);
+	}
+
+	void (*type_added_func_before)(const StringName &) = ResourceCache::retained_type_added_func;
+	ResourceCache::retained_type_added_func = _retained_type_added;
+	retained_type_added = StringName();
+	const uint64_t budget_before = ResourceCache::get_retained_budget();
+	ResourceCache::set_retained_budget(1024 * 1024);
+
+	Ref<Resource> loaded = ResourceLoader::load(save_path);
+	REQUIRE(loaded.is_valid());
+	CHECK_MESSAGE(ResourceCache::get_retained_size_for_type("Translation") == 0, "Resources in use shouldn't be retained.");
+
+	const WorkerThreadPool::TaskID task_id = WorkerThreadPool::get_singleton()->add_native_task(&_release_resource, &loaded);
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(task_id);
+	CHECK(loaded.is_null());
+	CHECK_MESSAGE(ResourceCache::has(save_path), "The released resource should still be cached.");
+	CHECK(ResourceCache::get_retained_size_for_type("Translation") > 0);
+	CHECK(retained_type_added == "Translation");
+
+	ResourceCache::set_retained_budget(0);
+	CHECK(ResourceCache::get_retained_size_for_type("Translation") == 0);
+	CHECK_MESSAGE(!ResourceCache::has(save_path), "The evicted resource should be freed.");
+
+	ResourceCache::set_retained_budget(budget_before);
+	ResourceCache::retained_type_added_func = type_added_func_before;
+}
 } // namespace TestResource
 
 #endif // TEST_RESOURCE_H
@@ -290,6 +290,30 @@ TEST_CASE("[Object] Absent name getter") {
 			"The returned value should equal nil variant.");
 }
 
+class _SignalReceiverObject : public Object {
+public:
+	int id = 0;
+	Vector<int> *log = nullptr;
+
+	// Connection changes to make on the next call, while the signal is being emitted.
+	Object *emitter = nullptr;
+	Callable to_disconnect;
+	Callable to_connect;
+
+	void receive() {
+		log->push_back(id);
+		if (emitter) {
+			emitter->disconnect("my_custom_signal", to_disconnect);
+			emitter->connect("my_custom_signal", to_connect);
+			emitter = nullptr;
+		}
+	}
+
+	void receive_bound(const Ref<RefCounted> &p_bound) {
+		receive();
+	}
+};
+
 TEST_CASE("[Object] Signals") {
 	Object object;
 
@@ -408,6 +432,64 @@ TEST_CASE("[Object] Signals") {
 		SIGNAL_UNWATCH(&object, "my_custom_signal");
 	}
 
+	SUBCASE("Connections changed during emission should only affect the next emission") {
+		Vector<int> log;
+		_SignalReceiverObject receivers[4];
+		for (int i = 0; i < 4; i++) {
+			receivers[i].id = i;
+			receivers[i].log = &log;
+		}
+		for (int i = 0; i < 3; i++) {
+			object.connect("my_custom_signal", callable_mp(&receivers[i], &_SignalReceiverObject::receive));
+		}
+		receivers[0].emitter = &object;
+		receivers[0].to_disconnect = callable_mp(&receivers[1], &_SignalReceiverObject::receive);
+		receivers[0].to_connect = callable_mp(&receivers[3], &_SignalReceiverObject::receive);
+
+		object.emit_signal("my_custom_signal");
+		CHECK(log == Vector<int>({ 0, 1, 2 }));
+
+		log.clear();
+		object.emit_signal("my_custom_signal");
+		CHECK(log == Vector<int>({ 0, 2, 3 }));
+
+		object.disconnect("my_custom_signal", callable_mp(&receivers[0], &_SignalReceiverObject::receive));
+		object.disconnect("my_custom_signal", callable_mp(&receivers[2], &_SignalReceiverObject::receive));
+		object.disconnect("my_custom_signal", callable_mp(&receivers[3], &_SignalReceiverObject::receive));
+	}
+
+	SUBCASE("Disconnecting should release bound arguments without another emission") {
+		Vector<int> log;
+		_SignalReceiverObject receiver;
+		receiver.log = &log;
+
+		Ref<RefCounted> bound;
+		bound.instantiate();
+		const ObjectID bound_id = bound->get_instance_id();
+		Callable callable = callable_mp(&receiver, &_SignalReceiverObject::receive_bound).bind(bound);
+		bound.unref();
+
+		object.connect("my_custom_signal", callable);
+		object.emit_signal("my_custom_signal");
+		CHECK(log.size() == 1);
+
+		object.disconnect("my_custom_signal", callable);
+		callable = Callable();
+		CHECK_MESSAGE(ObjectDB::get_instance(bound_id) == nullptr, "The bound object should be freed once the connection is gone.");
+	}
+
+	SUBCASE("One-shot connections should be called once") {
+		Vector<int> log;
+		_SignalReceiverObject receiver;
+		receiver.log = &log;
+		object.connect("my_custom_signal", callable_mp(&receiver, &_SignalReceiverObject::receive), Object::CONNECT_ONE_SHOT);
+
+		object.emit_signal("my_custom_signal");
+		object.emit_signal("my_custom_signal");
+		CHECK(log.size() == 1);
+		CHECK_FALSE(object.is_connected("my_custom_signal", callable_mp(&receiver, &_SignalReceiverObject::receive)));
+	}
+
 	SUBCASE("Connecting and then disconnecting many signals should not leave anything behind") {
 		List<Object::Connection> signal_connections;
 		Object targets[100];
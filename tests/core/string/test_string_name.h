@@ -0,0 +1,87 @@
+/**************************************************************************/
+/*  test_string_name.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/object/worker_thread_pool.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	const StringName a = "interning_test";
+	const StringName b = String("interning_test");
+	const StringName c = StringName(StaticCString::create("interning_test"));
+
+	CHECK(a == b);
+	CHECK(b == c);
+	CHECK(a.data_unique_pointer() == c.data_unique_pointer());
+	CHECK(StringName::search("interning_test") == a);
+	CHECK(StringName::search("interning_test_missing") == StringName());
+}
+
+static const int THREADED_NAME_COUNT = 1000;
+static const int THREADED_TASK_COUNT = 16;
+static LocalVector<StringName> threaded_results;
+
+static void intern_names(void *p_userdata, uint32_t p_index) {
+	// Short-lived names are created too, so that concurrent lookups race with
+	// both insertions into and removals from the table.
+	for (int i = 0; i < THREADED_NAME_COUNT; i++) {
+		threaded_results[p_index * THREADED_NAME_COUNT + i] = StringName("threaded_interning_" + itos(i));
+		StringName transient = StringName("threaded_interning_transient_" + itos((i + p_index) % 10));
+	}
+}
+
+TEST_CASE("[StringName] Interning from multiple threads") {
+	threaded_results.clear();
+	threaded_results.resize(THREADED_NAME_COUNT * THREADED_TASK_COUNT);
+
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(&intern_names, nullptr, THREADED_TASK_COUNT, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+	// Results keep every name referenced, so each must have been interned only once.
+	bool all_equal = true;
+	for (int i = 0; i < THREADED_NAME_COUNT; i++) {
+		for (int j = 1; j < THREADED_TASK_COUNT; j++) {
+			all_equal = all_equal && threaded_results[j * THREADED_NAME_COUNT + i] == threaded_results[i];
+		}
+	}
+	CHECK(all_equal);
+
+	threaded_results.clear();
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
@@ -31,6 +31,7 @@
 #ifndef TEST_HASH_MAP_H
 #define TEST_HASH_MAP_H
 
+#include "core/templates/block_allocator.h"
 #include "core/templates/hash_map.h"
 
 #include "tests/test_macros.h"
@@ -128,6 +129,78 @@ TEST_CASE("[HashMap] Const iteration") {
 		++idx;
 	}
 }
+
+TEST_CASE("[HashMap] Block allocator") {
+	typedef HashMap<int, String, HashMapHasherDefault, HashMapComparatorDefault<int>, BlockTypedAllocator<HashMapElement<int, String>>> BlockMap;
+	BlockMap map;
+
+	// Spans several blocks.
+	for (int i = 0; i < 100; i++) {
+		map.insert(i, itos(i));
+	}
+	CHECK(map.size() == 100);
+
+	// Pointers stay valid while the map grows.
+	String *ptr = map.getptr(7);
+	for (int i = 100; i < 200; i++) {
+		map.insert(i, itos(i));
+	}
+	CHECK(ptr == map.getptr(7));
+	CHECK(*ptr == "7");
+
+	// Freed elements are recycled, insertion order is kept.
+	for (int i = 0; i < 200; i += 2) {
+		map.erase(i);
+	}
+	map.insert(1000, "1000");
+	CHECK(map.size() == 101);
+	int idx = 0;
+	for (const KeyValue<int, String> &E : map) {
+		if (idx < 100) {
+			CHECK(E.key == idx * 2 + 1);
+		} else {
+			CHECK(E.key == 1000);
+		}
+		CHECK(E.value == itos(E.key));
+		idx++;
+	}
+
+	// Copies get their own allocator.
+	BlockMap copy = map;
+	map.clear();
+	CHECK(map.is_empty());
+	CHECK(copy.size() == 101);
+	CHECK(copy[1000] == "1000");
+
+	map.insert(5, "5");
+	CHECK(map.size() == 1);
+	CHECK(map[5] == "5");
+}
+
+TEST_CASE("[HashMap] Block allocator block sizes") {
+	BlockTypedAllocator<HashMapElement<int, int>> allocator;
+	LocalVector<HashMapElement<int, int> *> elements;
+
+	// Small containers only reserve a couple of elements.
+	elements.push_back(allocator.new_allocation(HashMapElement<int, int>(0, 0)));
+	CHECK(allocator.get_block_count() == 1);
+	elements.push_back(allocator.new_allocation(HashMapElement<int, int>(1, 1)));
+	CHECK(allocator.get_block_count() == 1);
+
+	// Blocks grow geometrically: 2 + 4 + 8 elements.
+	for (int i = 2; i < 14; i++) {
+		elements.push_back(allocator.new_allocation(HashMapElement<int, int>(i, i)));
+	}
+	CHECK(allocator.get_block_count() == 3);
+	CHECK(allocator.get_allocs_used() == 14);
+
+	// Everything is released once the last element is freed.
+	for (HashMapElement<int, int> *element : elements) {
+		allocator.delete_allocation(element);
+	}
+	CHECK(allocator.get_allocs_used() == 0);
+	CHECK(allocator.get_block_count() == 0);
+}
 } // namespace TestHashMap
 
 #endif // TEST_HASH_MAP_H
@@ -94,6 +94,30 @@ TEST_CASE("[LRU] Resize and clear") {
 	CHECK(!lru.has(3));
 	CHECK(!lru.has(4));
 }
+
+TEST_CASE("[LRU] Erase and pop least recent") {
+	LRUCache<int, int> lru;
+
+	lru.set_capacity(4);
+	lru.insert(1, 10);
+	lru.insert(2, 20);
+	lru.insert(3, 30);
+
+	CHECK(lru.erase(2));
+	CHECK(!lru.erase(2));
+	CHECK(!lru.has(2));
+	CHECK(lru.get_size() == 2);
+
+	lru.get(1); // <3> is now the least recent.
+	int data = 0;
+	CHECK(lru.pop_least_recent(&data));
+	CHECK(data == 30);
+	CHECK(!lru.has(3));
+
+	CHECK(lru.pop_least_recent());
+	CHECK(!lru.pop_least_recent());
+	CHECK(lru.get_size() == 0);
+}
 } // namespace TestLRU
 
 #endif // TEST_LRU_H
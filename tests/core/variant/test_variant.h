@@ -1806,6 +1806,41 @@ TEST_CASE("[Variant] Writer and parser dictionary") {
 	CHECK_MESSAGE(d_parsed == Variant(d), "Should parse back.");
 }
 
+TEST_CASE("[Variant] Parser constructor arguments") {
+	struct ParseCase {
+		const char *text;
+		Variant expected;
+	};
+	const ParseCase cases[] = {
+		{ "Vector3(1, -2.5, 3e2)", Vector3(1, -2.5, 300) },
+		{ "Vector2i(7,\n-8)", Vector2i(7, -8) },
+		{ "PackedFloat32Array(0.5, 1.5e-1, -1e+2)", PackedFloat32Array({ 0.5f, 0.15f, -100.0f }) },
+		{ "PackedInt64Array(9223372036854775807, -1)", PackedInt64Array({ INT64_MAX, -1 }) },
+		{ "PackedByteArray( 1 , 2 ,255 )", PackedByteArray({ 1, 2, 255 }) },
+		{ "PackedInt32Array()", PackedInt32Array() },
+		{ "Vector2(inf, inf_neg)", Vector2(INFINITY, -INFINITY) },
+		{ "\"caf\\u00e9 \\\"quoted\\\"\"", String::utf8("café \"quoted\"") },
+	};
+
+	for (const ParseCase &parse_case : cases) {
+		VariantParser::StreamString ss;
+		ss.s = parse_case.text;
+		String errs;
+		int line = 1;
+		Variant parsed;
+		CHECK(VariantParser::parse(&ss, parsed, errs, line) == OK);
+		CHECK_MESSAGE(parsed == parse_case.expected, parse_case.text);
+	}
+
+	VariantParser::StreamString ss;
+	ss.s = "PackedFloat32Array(1,\n2,";
+	String errs;
+	int line = 1;
+	Variant parsed;
+	CHECK(VariantParser::parse(&ss, parsed, errs, line) == ERR_PARSE_ERROR);
+	CHECK(line == 2);
+}
+
 TEST_CASE("[Variant] Writer recursive dictionary") {
 	// There is no way to accurately represent a recursive dictionary,
 	// the only thing we can do is make sure the writer doesn't blow up
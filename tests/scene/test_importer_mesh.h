@@ -0,0 +1,115 @@
+/**************************************************************************/
+/*  test_importer_mesh.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_IMPORTER_MESH_H
+#define TEST_IMPORTER_MESH_H
+
+#include "scene/resources/3d/importer_mesh.h"
+#include "scene/resources/3d/primitive_meshes.h"
+#include "scene/resources/surface_tool.h"
+
+#include "tests/test_macros.h"
+
+namespace TestImporterMesh {
+
+static Array sphere_arrays() {
+	Ref<SphereMesh> sphere;
+	sphere.instantiate();
+	return sphere->get_mesh_arrays();
+}
+
+static Array cylinder_arrays() {
+	Ref<CylinderMesh> cylinder;
+	cylinder.instantiate();
+	cylinder->set_radial_segments(48);
+	cylinder->set_rings(8);
+	return cylinder->get_mesh_arrays();
+}
+
+static void check_surfaces_match(const Ref<ImporterMesh> &p_mesh, int p_surface, const Ref<ImporterMesh> &p_expected, int p_expected_surface) {
+	Array arrays = p_mesh->get_surface_arrays(p_surface);
+	Array expected_arrays = p_expected->get_surface_arrays(p_expected_surface);
+	CHECK(PackedVector3Array(arrays[RS::ARRAY_VERTEX]) == PackedVector3Array(expected_arrays[RS::ARRAY_VERTEX]));
+	CHECK(PackedVector3Array(arrays[RS::ARRAY_NORMAL]) == PackedVector3Array(expected_arrays[RS::ARRAY_NORMAL]));
+	CHECK(PackedInt32Array(arrays[RS::ARRAY_INDEX]) == PackedInt32Array(expected_arrays[RS::ARRAY_INDEX]));
+
+	REQUIRE(p_mesh->get_surface_lod_count(p_surface) == p_expected->get_surface_lod_count(p_expected_surface));
+	for (int i = 0; i < p_mesh->get_surface_lod_count(p_surface); i++) {
+		CHECK(p_mesh->get_surface_lod_size(p_surface, i) == p_expected->get_surface_lod_size(p_expected_surface, i));
+		CHECK(p_mesh->get_surface_lod_indices(p_surface, i) == p_expected->get_surface_lod_indices(p_expected_surface, i));
+	}
+}
+
+TEST_CASE("[SceneTree][ImporterMesh] Threaded LOD and shadow mesh generation matches single surfaces") {
+	const Array surface_arrays[] = { sphere_arrays(), cylinder_arrays(), sphere_arrays() };
+	const int surface_count = 3;
+
+	// Surfaces of a multi-surface mesh are processed in parallel, each one on its own.
+	Ref<ImporterMesh> combined;
+	combined.instantiate();
+	for (int i = 0; i < surface_count; i++) {
+		combined->add_surface(Mesh::PRIMITIVE_TRIANGLES, surface_arrays[i].duplicate(true));
+	}
+	combined->generate_lods(60, 25, Array());
+	combined->create_shadow_mesh();
+
+	for (int i = 0; i < surface_count; i++) {
+		Ref<ImporterMesh> single;
+		single.instantiate();
+		single->add_surface(Mesh::PRIMITIVE_TRIANGLES, surface_arrays[i].duplicate(true));
+		single->generate_lods(60, 25, Array());
+		single->create_shadow_mesh();
+
+		if (SurfaceTool::simplify_scale_func) {
+			CHECK_MESSAGE(single->get_surface_lod_count(0) > 0, "The test mesh should be large enough to get LODs.");
+		}
+
+		check_surfaces_match(combined, i, single, 0);
+
+		REQUIRE(combined->get_shadow_mesh().is_valid());
+		REQUIRE(single->get_shadow_mesh().is_valid());
+		check_surfaces_match(combined->get_shadow_mesh(), i, single->get_shadow_mesh(), 0);
+	}
+
+	// The same input gives the same output on every run.
+	Ref<ImporterMesh> again;
+	again.instantiate();
+	for (int i = 0; i < surface_count; i++) {
+		again->add_surface(Mesh::PRIMITIVE_TRIANGLES, surface_arrays[i].duplicate(true));
+	}
+	again->generate_lods(60, 25, Array());
+	for (int i = 0; i < surface_count; i++) {
+		check_surfaces_match(again, i, combined, i);
+	}
+}
+
+} // namespace TestImporterMesh
+
+#endif // TEST_IMPORTER_MESH_H
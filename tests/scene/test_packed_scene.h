@@ -150,6 +150,48 @@ TEST_CASE("[PackedScene] Instantiate Packed Scene With Children") {
 	memdelete(instance);
 }
 
+TEST_CASE("[PackedScene] Instantiate Packed Scene Repeatedly") {
+	// Create a scene with non-default properties.
+	Node *scene = memnew(Node);
+	scene->set_name("TestScene");
+	scene->set_process_priority(5);
+
+	Node *child = memnew(Node);
+	child->set_name("Child");
+	child->set_process_mode(Node::PROCESS_MODE_DISABLED);
+	child->set_physics_process_priority(-3);
+	scene->add_child(child);
+	child->set_owner(scene);
+
+	PackedScene packed_scene;
+	packed_scene.pack(scene);
+
+	// Every instance gets the same properties.
+	for (int i = 0; i < 3; i++) {
+		Node *instance = packed_scene.instantiate();
+		CHECK(instance != nullptr);
+		CHECK(instance->get_process_priority() == 5);
+		CHECK(instance->get_child_count() == 1);
+		CHECK(instance->get_child(0)->get_process_mode() == Node::PROCESS_MODE_DISABLED);
+		CHECK(instance->get_child(0)->get_physics_process_priority() == -3);
+		memdelete(instance);
+	}
+
+	// Packing again picks up the new properties.
+	scene->set_process_priority(7);
+	child->set_process_mode(Node::PROCESS_MODE_ALWAYS);
+	packed_scene.pack(scene);
+
+	Node *instance = packed_scene.instantiate();
+	CHECK(instance != nullptr);
+	CHECK(instance->get_process_priority() == 7);
+	CHECK(instance->get_child(0)->get_process_mode() == Node::PROCESS_MODE_ALWAYS);
+	CHECK(instance->get_child(0)->get_physics_process_priority() == -3);
+
+	memdelete(scene);
+	memdelete(instance);
+}
+
 TEST_CASE("[PackedScene] Set Path") {
 	// Create a scene to pack.
 	Node *scene = memnew(Node);
@@ -0,0 +1,158 @@
+/**************************************************************************/
+/*  test_surface_tool.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SURFACE_TOOL_H
+#define TEST_SURFACE_TOOL_H
+
+#include "scene/resources/surface_tool.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSurfaceTool {
+
+static void add_grid(const Ref<SurfaceTool> &p_st, int p_size) {
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			Vector3 a(x, 0, z);
+			Vector3 b(x + 1, 0, z);
+			Vector3 c(x, 0, z + 1);
+			Vector3 d(x + 1, 0, z + 1);
+			p_st->add_vertex(a);
+			p_st->add_vertex(b);
+			p_st->add_vertex(c);
+			p_st->add_vertex(b);
+			p_st->add_vertex(d);
+			p_st->add_vertex(c);
+		}
+	}
+}
+
+TEST_CASE("[SurfaceTool] Indexing merges identical vertices") {
+	Ref<SurfaceTool> st;
+	st.instantiate();
+	st->begin(Mesh::PRIMITIVE_TRIANGLES);
+
+	SUBCASE("Shared vertices are merged") {
+		add_grid(st, 1);
+		st->index();
+		Array arrays = st->commit_to_arrays();
+		CHECK(PackedVector3Array(arrays[Mesh::ARRAY_VERTEX]).size() == 4);
+		CHECK(PackedInt32Array(arrays[Mesh::ARRAY_INDEX]).size() == 6);
+	}
+
+	SUBCASE("Vertices with different attributes are kept apart") {
+		st->set_uv(Vector2(0, 0));
+		st->add_vertex(Vector3(0, 0, 0));
+		st->add_vertex(Vector3(1, 0, 0));
+		st->add_vertex(Vector3(0, 0, 1));
+		st->set_uv(Vector2(1, 1));
+		st->add_vertex(Vector3(0, 0, 0));
+		st->add_vertex(Vector3(1, 0, 0));
+		st->add_vertex(Vector3(0, 0, 1));
+		st->index();
+		Array arrays = st->commit_to_arrays();
+		CHECK(PackedVector3Array(arrays[Mesh::ARRAY_VERTEX]).size() == 6);
+	}
+
+	SUBCASE("Large meshes are indexed the same way") {
+		const int size = 80;
+		add_grid(st, size);
+		st->index();
+		Array arrays = st->commit_to_arrays();
+		CHECK(PackedVector3Array(arrays[Mesh::ARRAY_VERTEX]).size() == (size + 1) * (size + 1));
+		PackedInt32Array indices = arrays[Mesh::ARRAY_INDEX];
+		REQUIRE(indices.size() == size * size * 6);
+		CHECK(indices[0] == 0);
+		CHECK(indices[1] == 1);
+		CHECK(indices[2] == 2);
+		CHECK(indices[3] == 1);
+	}
+}
+
+TEST_CASE("[SurfaceTool] Generating normals") {
+	Ref<SurfaceTool> st;
+	st.instantiate();
+	st->begin(Mesh::PRIMITIVE_TRIANGLES);
+
+	SUBCASE("Smoothed normals are shared across faces") {
+		// Two faces folded along the X axis.
+		st->add_vertex(Vector3(0, 0, 0));
+		st->add_vertex(Vector3(1, 0, 0));
+		st->add_vertex(Vector3(0, 1, 1));
+		st->add_vertex(Vector3(1, 0, 0));
+		st->add_vertex(Vector3(0, 0, 0));
+		st->add_vertex(Vector3(0, 1, -1));
+		st->generate_normals();
+		Array arrays = st->commit_to_arrays();
+		PackedVector3Array normals = arrays[Mesh::ARRAY_NORMAL];
+		REQUIRE(normals.size() == 6);
+		CHECK(normals[0].is_equal_approx(normals[4]));
+		CHECK(normals[1].is_equal_approx(normals[3]));
+		CHECK(normals[0].is_normalized());
+		CHECK_FALSE(normals[2].is_equal_approx(normals[5]));
+	}
+
+	SUBCASE("Flat normals when not in a smoothing group") {
+		st->set_smooth_group(UINT32_MAX);
+		st->add_vertex(Vector3(0, 0, 0));
+		st->add_vertex(Vector3(1, 0, 0));
+		st->add_vertex(Vector3(0, 1, 1));
+		st->add_vertex(Vector3(1, 0, 0));
+		st->add_vertex(Vector3(0, 0, 0));
+		st->add_vertex(Vector3(0, 1, -1));
+		st->generate_normals();
+		Array arrays = st->commit_to_arrays();
+		PackedVector3Array normals = arrays[Mesh::ARRAY_NORMAL];
+		REQUIRE(normals.size() == 6);
+		CHECK(normals[0].is_equal_approx(normals[2]));
+		CHECK(normals[3].is_equal_approx(normals[5]));
+		CHECK_FALSE(normals[0].is_equal_approx(normals[3]));
+	}
+
+	SUBCASE("Large meshes get consistent normals") {
+		const int size = 80;
+		add_grid(st, size);
+		st->index();
+		st->generate_normals();
+		Array arrays = st->commit_to_arrays();
+		PackedVector3Array normals = arrays[Mesh::ARRAY_NORMAL];
+		REQUIRE(normals.size() == (size + 1) * (size + 1));
+		bool all_equal = true;
+		for (int i = 0; i < normals.size(); i++) {
+			all_equal = all_equal && normals[i].is_equal_approx(normals[0]);
+		}
+		CHECK(all_equal);
+		CHECK(Math::is_equal_approx(Math::abs(normals[0].y), (real_t)1.0));
+	}
+}
+
+} // namespace TestSurfaceTool
+
+#endif // TEST_SURFACE_TOOL_H
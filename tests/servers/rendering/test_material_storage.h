@@ -0,0 +1,94 @@
+/**************************************************************************/
+/*  test_material_storage.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_MATERIAL_STORAGE_H
+#define TEST_MATERIAL_STORAGE_H
+
+#include "servers/rendering_server.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMaterialStorage {
+
+static String uniform_shader_code(const String &p_uniform) {
+	return "shader_type spatial;\nuniform float " + p_uniform + " = 1.0;\nvoid fragment() {\n\tALBEDO = vec3(" + p_uniform + ");\n}\n";
+}
+
+static bool has_parameter(RID p_shader, const String &p_name) {
+	List<PropertyInfo> params;
+	RS::get_singleton()->get_shader_parameter_list(p_shader, &params);
+	for (const PropertyInfo &E : params) {
+		if (E.name == p_name) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Tests run with the dummy renderer, which parses shaders on worker threads.
+TEST_CASE("[SceneTree][MaterialStorage] Shader parameters are available right after setting the code") {
+	const int shader_count = 32;
+	RID shaders[shader_count];
+
+	for (int i = 0; i < shader_count; i++) {
+		shaders[i] = RS::get_singleton()->shader_create();
+		RS::get_singleton()->shader_set_code(shaders[i], uniform_shader_code("value_" + itos(i)));
+	}
+
+	for (int i = 0; i < shader_count; i++) {
+		CHECK_MESSAGE(has_parameter(shaders[i], "value_" + itos(i)), "Querying parameters should wait for, or run, the pending compilation.");
+	}
+
+	SUBCASE("Setting new code replaces the parameters") {
+		RS::get_singleton()->shader_set_code(shaders[0], uniform_shader_code("first"));
+		RS::get_singleton()->shader_set_code(shaders[0], uniform_shader_code("second"));
+		CHECK_FALSE(has_parameter(shaders[0], "value_0"));
+		CHECK_FALSE(has_parameter(shaders[0], "first"));
+		CHECK(has_parameter(shaders[0], "second"));
+	}
+
+	SUBCASE("Shaders can be freed while their compilation is pending") {
+		for (int i = 0; i < shader_count; i++) {
+			RS::get_singleton()->shader_set_code(shaders[i], uniform_shader_code("pending_" + itos(i)));
+			RS::get_singleton()->free(shaders[i]);
+			shaders[i] = RID();
+		}
+	}
+
+	for (int i = 0; i < shader_count; i++) {
+		if (shaders[i].is_valid()) {
+			RS::get_singleton()->free(shaders[i]);
+		}
+	}
+}
+
+} // namespace TestMaterialStorage
+
+#endif // TEST_MATERIAL_STORAGE_H
@@ -0,0 +1,79 @@
+/**************************************************************************/
+/*  test_renderer_scene_cull.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERER_SCENE_CULL_H
+#define TEST_RENDERER_SCENE_CULL_H
+
+#include "core/math/random_pcg.h"
+#include "servers/rendering/renderer_scene_cull.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRendererSceneCull {
+
+TEST_CASE("[RendererSceneCull] Block culling matches per-instance culling") {
+	typedef RendererSceneCull::InstanceBounds InstanceBounds;
+	typedef RendererSceneCull::InstanceBoundsBlock InstanceBoundsBlock;
+
+	const Transform3D cam_transform = Transform3D(Basis::from_euler(Vector3(0.3, 0.8, 0.0)), Vector3(1, 2, 3));
+	const Projection cam_projection = Projection::create_perspective(75, 1.5, 0.05, 50);
+	const RendererSceneCull::Frustum frustum(cam_projection.get_projection_planes(cam_transform));
+	const AABB region = AABB(Vector3(-5, -5, -5), Vector3(10, 10, 10));
+
+	RandomPCG rng(42);
+	InstanceBounds bounds[InstanceBoundsBlock::SIZE];
+	InstanceBoundsBlock block;
+
+	for (int iteration = 0; iteration < 500; iteration++) {
+		for (uint32_t i = 0; i < InstanceBoundsBlock::SIZE; i++) {
+			Vector3 position = Vector3(rng.random(-40.0, 40.0), rng.random(-40.0, 40.0), rng.random(-40.0, 40.0));
+			Vector3 size = Vector3(rng.random(0.0, 5.0), rng.random(0.0, 5.0), rng.random(0.0, 5.0));
+			bounds[i] = InstanceBounds(AABB(position, size));
+			block.set(i, bounds[i], 1 << (i % 4), i == 3);
+		}
+
+		uint32_t frustum_mask = block.in_frustum_mask(frustum);
+		uint32_t aabb_mask = block.in_aabb_mask(region);
+		for (uint32_t i = 0; i < InstanceBoundsBlock::SIZE; i++) {
+			CHECK_MESSAGE(bool(frustum_mask & (1 << i)) == bounds[i].in_frustum(frustum), "Frustum test should match InstanceBounds.");
+			CHECK_MESSAGE(bool(aabb_mask & (1 << i)) == bounds[i].in_aabb(region), "AABB test should match InstanceBounds.");
+		}
+	}
+
+	CHECK_MESSAGE(block.layer_check_mask(1 << 2) == ((1 << 2) | (1 << 6)), "Only instances on the visible layers should pass.");
+	CHECK_MESSAGE(block.ignore_culling_mask == (1 << 3), "Ignore culling flag should be tracked per instance.");
+
+	block.set(3, bounds[3], 1, false);
+	CHECK_MESSAGE(block.ignore_culling_mask == 0, "Ignore culling flag should be cleared.");
+}
+
+} // namespace TestRendererSceneCull
+
+#endif // TEST_RENDERER_SCENE_CULL_H
@@ -0,0 +1,123 @@
+/**************************************************************************/
+/*  test_renderer_scene_occlusion_raster.h                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERER_SCENE_OCCLUSION_RASTER_H
+#define TEST_RENDERER_SCENE_OCCLUSION_RASTER_H
+
+#include "servers/rendering/renderer_scene_occlusion_raster.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRendererSceneOcclusionRaster {
+
+// A 4x4x1 box, 5 units in front of the camera.
+static void _make_box_occluder(PackedVector3Array &r_vertices, PackedInt32Array &r_indices) {
+	const AABB box = AABB(Vector3(-2, -2, -5.5), Vector3(4, 4, 1));
+	for (int i = 0; i < 8; i++) {
+		r_vertices.push_back(box.get_endpoint(i));
+	}
+	// Two triangles per face. Endpoint indices have one bit per axis: Z is the lowest, then Y and X.
+	const int faces[6][4] = { { 0, 1, 3, 2 }, { 4, 6, 7, 5 }, { 0, 4, 5, 1 }, { 2, 3, 7, 6 }, { 0, 2, 6, 4 }, { 1, 5, 7, 3 } };
+	for (const int *face : faces) {
+		const int triangles[6] = { face[0], face[1], face[2], face[0], face[2], face[3] };
+		for (int index : triangles) {
+			r_indices.push_back(index);
+		}
+	}
+}
+
+static bool _is_occluded(const RendererSceneOcclusionCull::HZBuffer *p_buffer, const AABB &p_aabb, const Transform3D &p_cam_transform, const Projection &p_cam_projection) {
+	const Vector3 end = p_aabb.get_end();
+	const real_t bounds[6] = { p_aabb.position.x, p_aabb.position.y, p_aabb.position.z, end.x, end.y, end.z };
+	return p_buffer->is_occluded(bounds, p_cam_transform.origin, p_cam_transform.affine_inverse(), p_cam_projection, p_cam_projection.get_z_near());
+}
+
+TEST_CASE("[RendererSceneOcclusionRaster] Box occluder") {
+	PackedVector3Array vertices;
+	PackedInt32Array indices;
+	_make_box_occluder(vertices, indices);
+
+	RendererSceneOcclusionRaster occlusion_cull;
+	const RID occluder = occlusion_cull.occluder_allocate();
+	occlusion_cull.occluder_initialize(occluder);
+	occlusion_cull.occluder_set_mesh(occluder, vertices, indices);
+
+	const RID scenario = RID::from_uint64(1);
+	const RID instance = RID::from_uint64(2);
+	const RID buffer = RID::from_uint64(3);
+	occlusion_cull.add_scenario(scenario);
+	occlusion_cull.scenario_set_instance(scenario, instance, occluder, Transform3D(), true);
+	occlusion_cull.add_buffer(buffer);
+	occlusion_cull.buffer_set_scenario(buffer, scenario);
+	occlusion_cull.buffer_set_size(buffer, Size2i(64, 64));
+
+	SUBCASE("Perspective camera") {
+		const Transform3D cam_transform;
+		const Projection cam_projection = Projection::create_perspective(90, 1.0, 0.1, 100);
+		occlusion_cull.buffer_update(buffer, cam_transform, cam_projection, false);
+		const RendererSceneOcclusionCull::HZBuffer *hz_buffer = occlusion_cull.buffer_get_ptr(buffer);
+		REQUIRE(hz_buffer);
+
+		CHECK_MESSAGE(_is_occluded(hz_buffer, AABB(Vector3(-0.5, -0.5, -20.5), Vector3(1, 1, 1)), cam_transform, cam_projection), "Behind the box.");
+		CHECK_MESSAGE(_is_occluded(hz_buffer, AABB(Vector3(-2.5, -2.5, -10.5), Vector3(1, 1, 1)), cam_transform, cam_projection), "Behind a corner of the box.");
+		CHECK_FALSE_MESSAGE(_is_occluded(hz_buffer, AABB(Vector3(14.5, -0.5, -20.5), Vector3(1, 1, 1)), cam_transform, cam_projection), "Next to the box.");
+		CHECK_FALSE_MESSAGE(_is_occluded(hz_buffer, AABB(Vector3(-0.5, -0.5, -3), Vector3(1, 1, 1)), cam_transform, cam_projection), "In front of the box.");
+		CHECK_FALSE_MESSAGE(_is_occluded(hz_buffer, AABB(Vector3(-10, -0.5, -20.5), Vector3(20, 1, 1)), cam_transform, cam_projection), "Wider than the box.");
+	}
+
+	SUBCASE("Orthogonal camera") {
+		const Transform3D cam_transform;
+		const Projection cam_projection = Projection::create_orthogonal(-5, 5, -5, 5, 0.1, 100);
+		occlusion_cull.buffer_update(buffer, cam_transform, cam_projection, true);
+		const RendererSceneOcclusionCull::HZBuffer *hz_buffer = occlusion_cull.buffer_get_ptr(buffer);
+		REQUIRE(hz_buffer);
+
+		CHECK_MESSAGE(_is_occluded(hz_buffer, AABB(Vector3(-0.5, -0.5, -20.5), Vector3(1, 1, 1)), cam_transform, cam_projection), "Behind the box.");
+		CHECK_FALSE_MESSAGE(_is_occluded(hz_buffer, AABB(Vector3(3, -0.5, -20.5), Vector3(1, 1, 1)), cam_transform, cam_projection), "Next to the box.");
+		CHECK_FALSE_MESSAGE(_is_occluded(hz_buffer, AABB(Vector3(-0.5, -0.5, -3), Vector3(1, 1, 1)), cam_transform, cam_projection), "In front of the box.");
+	}
+
+	SUBCASE("Disabled instance") {
+		occlusion_cull.scenario_set_instance(scenario, instance, occluder, Transform3D(), false);
+		const Transform3D cam_transform;
+		const Projection cam_projection = Projection::create_perspective(90, 1.0, 0.1, 100);
+		occlusion_cull.buffer_update(buffer, cam_transform, cam_projection, false);
+
+		CHECK_FALSE(_is_occluded(occlusion_cull.buffer_get_ptr(buffer), AABB(Vector3(-0.5, -0.5, -20.5), Vector3(1, 1, 1)), cam_transform, cam_projection));
+	}
+
+	occlusion_cull.remove_buffer(buffer);
+	occlusion_cull.scenario_remove_instance(scenario, instance);
+	occlusion_cull.remove_scenario(scenario);
+	occlusion_cull.free_occluder(occluder);
+}
+} // namespace TestRendererSceneOcclusionRaster
+
+#endif // TEST_RENDERER_SCENE_OCCLUSION_RASTER_H
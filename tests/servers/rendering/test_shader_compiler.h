@@ -0,0 +1,194 @@
+/**************************************************************************/
+/*  test_shader_compiler.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SHADER_COMPILER_H
+#define TEST_SHADER_COMPILER_H
+
+#include "servers/rendering/shader_compiler.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_tools.h"
+
+namespace TestShaderCompiler {
+
+// Stands in for the state a renderer's ShaderData points its IdentifierActions to.
+struct ShaderState {
+	bool unshaded = false;
+	int blend_mode = 0;
+	bool uses_alpha = false;
+	bool writes_albedo = false;
+	HashMap<StringName, ShaderLanguage::ShaderNode::Uniform> uniforms;
+
+	ShaderCompiler::IdentifierActions actions;
+
+	ShaderState() {
+		actions.entry_point_stages["vertex"] = ShaderCompiler::STAGE_VERTEX;
+		actions.entry_point_stages["fragment"] = ShaderCompiler::STAGE_FRAGMENT;
+		actions.render_mode_flags["unshaded"] = &unshaded;
+		actions.render_mode_values["blend_add"] = Pair<int *, int>(&blend_mode, 1);
+		actions.usage_flag_pointers["ALPHA"] = &uses_alpha;
+		actions.write_flag_pointers["ALBEDO"] = &writes_albedo;
+		actions.uniforms = &uniforms;
+	}
+};
+
+static const char *shader_code = R"(
+shader_type spatial;
+render_mode unshaded, blend_add;
+
+uniform float strength = 1.0;
+
+void fragment() {
+	ALBEDO = vec3(strength);
+	ALPHA = 0.5;
+}
+)";
+
+TEST_CASE("[SceneTree][ShaderCompiler] Cache hits replay the compilation effects") {
+	ShaderCompiler compiler;
+	compiler.initialize(ShaderCompiler::DefaultIdentifierActions());
+
+	ShaderState first;
+	ShaderCompiler::GeneratedCode first_code;
+	REQUIRE(compiler.compile(RS::SHADER_SPATIAL, shader_code, &first.actions, "", first_code) == OK);
+	CHECK(compiler.get_compile_cache_misses() == 1);
+	CHECK(compiler.get_compile_cache_hits() == 0);
+
+	CHECK(first.unshaded);
+	CHECK(first.blend_mode == 1);
+	CHECK(first.uses_alpha);
+	CHECK(first.writes_albedo);
+	CHECK(first.uniforms.has("strength"));
+
+	ShaderState second;
+	ShaderCompiler::GeneratedCode second_code;
+	REQUIRE(compiler.compile(RS::SHADER_SPATIAL, shader_code, &second.actions, "", second_code) == OK);
+	CHECK_MESSAGE(compiler.get_compile_cache_hits() == 1, "Identical code should be served from the cache.");
+	CHECK(compiler.get_compile_cache_misses() == 1);
+
+	CHECK_MESSAGE(second.unshaded, "Render mode flags should be replayed.");
+	CHECK_MESSAGE(second.blend_mode == 1, "Render mode values should be replayed.");
+	CHECK_MESSAGE(second.uses_alpha, "Usage flags should be replayed.");
+	CHECK_MESSAGE(second.writes_albedo, "Write flags should be replayed.");
+	REQUIRE_MESSAGE(second.uniforms.has("strength"), "Uniforms should be replayed.");
+	CHECK(second.uniforms["strength"].type == first.uniforms["strength"].type);
+	CHECK(second.uniforms["strength"].order == first.uniforms["strength"].order);
+
+	CHECK(second_code.code["fragment"] == first_code.code["fragment"]);
+	CHECK(second_code.uniforms == first_code.uniforms);
+	CHECK(second_code.uniform_total_size == first_code.uniform_total_size);
+
+	// The cache is keyed on the shader mode as well as the code.
+	ShaderState third;
+	ShaderCompiler::GeneratedCode third_code;
+	ERR_PRINT_OFF;
+	compiler.compile(RS::SHADER_CANVAS_ITEM, shader_code, &third.actions, "", third_code);
+	ERR_PRINT_ON;
+	CHECK(compiler.get_compile_cache_hits() == 1);
+	CHECK(compiler.get_compile_cache_misses() == 2);
+}
+
+TEST_CASE("[SceneTree][ShaderCompiler] Cached errors are reported again") {
+	ShaderCompiler compiler;
+	compiler.initialize(ShaderCompiler::DefaultIdentifierActions());
+
+	const String broken_code = "shader_type spatial;\n\nvoid fragment() {\n\tALBEDO = undefined_variable;\n}\n";
+
+	for (int i = 0; i < 2; i++) {
+		ShaderState state;
+		ShaderCompiler::GeneratedCode gen_code;
+		ErrorDetector ed;
+
+		ERR_PRINT_OFF;
+		Error err = compiler.compile(RS::SHADER_SPATIAL, broken_code, &state.actions, "res://broken.gdshader", gen_code);
+		ERR_PRINT_ON;
+
+		CHECK(err != OK);
+		CHECK_MESSAGE(ed.has_error, "The error should be reported on every compilation, cached or not.");
+		CHECK_FALSE(state.writes_albedo);
+	}
+
+	CHECK(compiler.get_compile_cache_misses() == 1);
+	CHECK(compiler.get_compile_cache_hits() == 1);
+}
+
+TEST_CASE("[SceneTree][ShaderCompiler] Initializing clears the cache") {
+	ShaderCompiler compiler;
+	compiler.initialize(ShaderCompiler::DefaultIdentifierActions());
+
+	ShaderState state;
+	ShaderCompiler::GeneratedCode gen_code;
+	REQUIRE(compiler.compile(RS::SHADER_SPATIAL, shader_code, &state.actions, "", gen_code) == OK);
+
+	// New default actions change the generated code, so earlier results can't be reused.
+	ShaderCompiler::DefaultIdentifierActions actions;
+	actions.renames["ALBEDO"] = "albedo_output";
+	compiler.initialize(actions);
+
+	ShaderState renamed;
+	ShaderCompiler::GeneratedCode renamed_code;
+	REQUIRE(compiler.compile(RS::SHADER_SPATIAL, shader_code, &renamed.actions, "", renamed_code) == OK);
+	CHECK(compiler.get_compile_cache_hits() == 0);
+	CHECK(renamed_code.code["fragment"].contains("albedo_output"));
+}
+
+TEST_CASE("[SceneTree][ShaderCompiler] Compilers can share a cache") {
+	ShaderCompiler::CompileCache shared_cache;
+	ShaderCompiler first_compiler;
+	first_compiler.initialize(ShaderCompiler::DefaultIdentifierActions());
+	first_compiler.set_compile_cache(&shared_cache);
+	ShaderCompiler second_compiler;
+	second_compiler.initialize(ShaderCompiler::DefaultIdentifierActions());
+	second_compiler.set_compile_cache(&shared_cache);
+
+	ShaderState first;
+	ShaderCompiler::GeneratedCode first_code;
+	REQUIRE(first_compiler.compile(RS::SHADER_SPATIAL, shader_code, &first.actions, "", first_code) == OK);
+
+	ShaderState second;
+	ShaderCompiler::GeneratedCode second_code;
+	REQUIRE(second_compiler.compile(RS::SHADER_SPATIAL, shader_code, &second.actions, "", second_code) == OK);
+	CHECK_MESSAGE(second_compiler.get_compile_cache_hits() == 1, "Code compiled by another compiler sharing the cache should be served from it.");
+	CHECK(first_compiler.get_compile_cache_misses() == 1);
+	CHECK(second.writes_albedo);
+	CHECK(second_code.code["fragment"] == first_code.code["fragment"]);
+
+	// Back to its own cache, which is empty.
+	second_compiler.set_compile_cache(nullptr);
+	ShaderState third;
+	ShaderCompiler::GeneratedCode third_code;
+	REQUIRE(second_compiler.compile(RS::SHADER_SPATIAL, shader_code, &third.actions, "", third_code) == OK);
+	CHECK(second_compiler.get_compile_cache_hits() == 0);
+	CHECK(second_compiler.get_compile_cache_misses() == 1);
+}
+
+} // namespace TestShaderCompiler
+
+#endif // TEST_SHADER_COMPILER_H